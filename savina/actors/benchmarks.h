@@ -1,11 +1,14 @@
+// Benchmarks register themselves in include order, which is the order the
+// suite runs and reports them in. It is kept as it was before the registry,
+// with later additions at the end, so that results line up with older runs.
 #include "concurrency/banking.h"
 #include "concurrency/barber.h"
 #include "concurrency/bndbuffer.h"
 #include "concurrency/cigsmok.h"
 #include "concurrency/concdict.h"
-#include "concurrency/concsll.h"
-#include "concurrency/logmap.h"
 #include "concurrency/philosopher.h"
+#include "concurrency/logmap.h"
+#include "concurrency/concsll.h"
 
 #include "micro/big.h"
 #include "micro/chameneos.h"
@@ -13,7 +16,6 @@
 #include "micro/fib.h"
 #include "micro/fjcreate.h"
 #include "micro/fjthroughput.h"
-#include "micro/nop.h"
 #include "micro/pingpong.h"
 #include "micro/threadring.h"
 
@@ -22,4 +24,6 @@
 #include "parallel/radixsort.h"
 #include "parallel/recmatmul.h"
 #include "parallel/sieve.h"
-#include "parallel/trapezoid.h"
\ No newline at end of file
+#include "parallel/trapezoid.h"
+
+#include "micro/nop.h"
\ No newline at end of file
@@ -53,9 +53,10 @@ struct Teller {
   SimpleRand random;
   uint64_t completed;
   std::vector<cown_ptr<Account>> accounts;
+  validation::Result<uint64_t>::Completion done;
 
-  Teller(double initial_balance, uint64_t num_accounts, uint64_t transactions, uint64_t seed):
-    initial_balance(initial_balance), transactions(transactions), random(SimpleRand(seed)), completed(0) {
+  Teller(double initial_balance, uint64_t num_accounts, uint64_t transactions, uint64_t seed, validation::Result<uint64_t>::Completion done):
+    initial_balance(initial_balance), transactions(transactions), random(SimpleRand(seed)), completed(0), done(done) {
 
     for (uint64_t i = 0; i < num_accounts; i++)
     {
@@ -64,35 +65,45 @@ struct Teller {
   }
 
   static void spawn_transactions(cown_ptr<Teller>&& self) {
-    when(self) << [tag=self](acquired_cown<Teller> self) mutable {
+    when(self) << stamped([tag=self](acquired_cown<Teller> self) mutable {
       for (uint64_t i = 0; i < self->transactions; i++)
       {
-        // Must have more than ten accounts for the following maths to work.
-        assert(self->accounts.size() > 10);
-        // Randomly pick source and destination account
-        uint64_t source = self->random.nextInt((self->accounts.size() / 10) * 8);
-        uint64_t dest = self->random.nextInt(self->accounts.size() - source);
+        self->transfer(tag);
+      }
+    });
+  }
 
-        if (dest == 0)
-          dest++;
+  void transfer(const cown_ptr<Teller>& tag) {
+    // Must have more than ten accounts for the following maths to work.
+    assert(accounts.size() > 10);
+    // Randomly pick source and destination account
+    uint64_t source = random.nextInt((accounts.size() / 10) * 8);
+    uint64_t dest = random.nextInt(accounts.size() - source);
 
-        Account::credit(self->accounts[source], tag, self->random.nextDouble() * 1000, self->accounts[source + dest]);
-      }
-    };
+    if (dest == 0)
+      dest++;
+
+    Account::credit(accounts[source], tag, random.nextDouble() * 1000, accounts[source + dest]);
   }
 
   static void reply(cown_ptr<Teller> self) {
-    when(self) << [](acquired_cown<Teller> self) {
+    when(self) << stamped([](acquired_cown<Teller> self) {
       self->completed++;
-      if (self->completed == self->transactions) {
+      Throughput::completed();
+      // With --duration, keep the same number of transactions in flight.
+      if (Throughput::more(false)) {
+        self->transfer(self.cown());
         return;
       }
-    };
+      if (self->completed == self->transactions) {
+        self->done(self->completed);
+      }
+    });
   }
 };
 
 void Account::debit(cown_ptr<Account> self, cown_ptr<Account> account, cown_ptr<Teller> teller, double amount) {
-  when(self) << [tag = self, account = std::move(account), teller = std::move(teller), amount](acquired_cown<Account> self) mutable {
+  when(self) << stamped([tag = self, account = std::move(account), teller = std::move(teller), amount](acquired_cown<Account> self) mutable {
     if (!self->stash_mode) {
       self->balance += amount;
       Account::reply(std::move(account), std::move(teller));
@@ -100,11 +111,11 @@ void Account::debit(cown_ptr<Account> self, cown_ptr<Account> account, cown_ptr<
     } else {
       self->stash.emplace_back(std::make_unique<DebitMessage>(std::move(account), std::move(teller), amount));
     }
-  };
+  });
 }
 
 void Account::credit(cown_ptr<Account> self, cown_ptr<Teller> teller, double amount, cown_ptr<Account> destination) {
-  when(self) << [teller = std::move(teller), amount, destination = std::move(destination)](acquired_cown<Account> self) mutable {
+  when(self) << stamped([teller = std::move(teller), amount, destination = std::move(destination)](acquired_cown<Account> self) mutable {
     if (!self->stash_mode) {
       self->balance -= amount;
       Account::debit(std::move(destination), self.cown(), std::move(teller), amount);
@@ -112,7 +123,7 @@ void Account::credit(cown_ptr<Account> self, cown_ptr<Teller> teller, double amo
     } else {
       self->stash.emplace_back(std::make_unique<CreditMessage>(std::move(destination), std::move(teller), amount));
     }
-  };
+  });
 }
 
 void Account::unstash(cown_ptr<Account> tag) {
@@ -125,11 +136,11 @@ void Account::unstash(cown_ptr<Account> tag) {
 }
 
 void Account::reply(cown_ptr<Account> self, cown_ptr<Teller> teller) {
-  when(self) << [tag=self, teller](acquired_cown<Account> self) mutable {
+  when(self) << stamped([tag=self, teller](acquired_cown<Account> self) mutable {
     Teller::reply(teller);
     self->unstash(tag);
     self->stash_mode = false;
-  };
+  });
 }
 
 };
@@ -138,6 +149,7 @@ struct Banking: public ActorBenchmark {
   uint64_t accounts;
   uint64_t transactions;
   double initial;
+  validation::Result<uint64_t> completed;
   inline static const std::string name = "Banking";
 
   Banking(uint64_t accounts, uint64_t transactions): accounts(accounts), transactions(transactions) {
@@ -146,8 +158,16 @@ struct Banking: public ActorBenchmark {
 
   void run() {
     auto seed = BenchmarkHarness::get_seed();
-    banking::Teller::spawn_transactions(make_cown<banking::Teller>(initial, accounts, transactions, seed));
+    banking::Teller::spawn_transactions(make_cown<banking::Teller>(initial, accounts, transactions, seed, completed.completion()));
   }
+
+  bool continuous() { return true; }
+
+  bool validates() { return true; }
+
+  std::string validate() { return validation::expect("completed transactions", completed.value, transactions); }
 };
 
+static const bool banking_registered = register_benchmark<Banking>(param<uint64_t>("accounts", 1000), param<uint64_t>("transactions", 50000));
+
 };
\ No newline at end of file
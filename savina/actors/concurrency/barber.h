@@ -57,7 +57,7 @@ struct WaitingRoom {
   WaitingRoom(uint64_t size, cown_ptr<Barber>&& barber): size(size), barber_sleeps(true), barber(barber) {}
 
   static void enter(cown_ptr<WaitingRoom>& self, cown_ptr<Customer> customer) {
-    when(self) << [tag=self, customer=move(customer)](acquired_cown<WaitingRoom> self) mutable {
+    when(self) << stamped([tag=self, customer=move(customer)](acquired_cown<WaitingRoom> self) mutable {
       if (self->customers.size() == self->size) {
         Customer::full(customer);
       } else {
@@ -70,11 +70,11 @@ struct WaitingRoom {
           Customer::wait(customer);
         }
       }
-    };
+    });
   }
 
   static void next(cown_ptr<WaitingRoom>& self) {
-    when(self) << [tag=self](acquired_cown<WaitingRoom> self)  mutable {
+    when(self) << stamped([tag=self](acquired_cown<WaitingRoom> self)  mutable {
       if (self->customers.size() > 0) {
         Barber::enter(self->barber, move(self->customers.front()), move(tag));
         self->customers.pop_front();
@@ -82,7 +82,7 @@ struct WaitingRoom {
         Barber::wait(self->barber);
         self->barber_sleeps = true;
       }
-    };
+    });
   }
 };
 
@@ -99,49 +99,48 @@ static uint64_t BusyWaiter(uint64_t wait, Rand& random) {
 }
 
 void Barber::enter(cown_ptr<Barber>& self, cown_ptr<Customer> customer, cown_ptr<WaitingRoom> room) {
-  when(self) << [customer=move(customer), room=move(room)](acquired_cown<Barber> self)  mutable {
+  when(self) << stamped([customer=move(customer), room=move(room)](acquired_cown<Barber> self)  mutable {
     Customer::sit_down(customer);
     BusyWaiter(self->random.integer(self->haircut_rate) + 10, self->random);
     Customer::pay_and_leave(customer);
     WaitingRoom::next(room);
-  };
+  });
 }
 
-void Barber::wait(cown_ptr<Barber>& self) { when(self) << [](acquired_cown<Barber>) mutable {}; }
+void Barber::wait(cown_ptr<Barber>& self) { when(self) << stamped([](acquired_cown<Barber>) mutable {}); }
 
 void CustomerFactory::returned(cown_ptr<CustomerFactory>& self, cown_ptr<Customer> customer) {
-  when(self) << [customer=move(customer)](acquired_cown<CustomerFactory> self)  mutable {
+  when(self) << stamped([customer=move(customer)](acquired_cown<CustomerFactory> self)  mutable {
     self->attempts++;
     WaitingRoom::enter(self->room, move(customer));
-  };
+  });
 }
 
 void CustomerFactory::left(cown_ptr<CustomerFactory>& self) {
-  when(self) << [](acquired_cown<CustomerFactory> self)  mutable {
+  when(self) << stamped([](acquired_cown<CustomerFactory> self)  mutable {
     self->number_of_haircuts--;
-    if (self->number_of_haircuts == 0) {
-      return;
-    }
-  };
+    if (self->number_of_haircuts == 0)
+      CompletionLatch::signal();
+  });
 }
 
 void CustomerFactory::run(cown_ptr<CustomerFactory>&& self, uint64_t rate) {
-  when(self) << [tag=self, rate](acquired_cown<CustomerFactory> self)  mutable {
+  when(self) << stamped([tag=self, rate](acquired_cown<CustomerFactory> self)  mutable {
     for (uint64_t i = 0; i < self->number_of_haircuts; ++i) {
       self->attempts++;
       WaitingRoom::enter(self->room, make_cown<Customer>(tag));
       BusyWaiter(self->random.integer(rate) + 10, self->random);
     }
-  };
+  });
 }
 
-void Customer::full(cown_ptr<Customer>& self) { when(self) << [tag=self](acquired_cown<Customer> self) mutable { CustomerFactory::returned(self->factory, tag); }; }
+void Customer::full(cown_ptr<Customer>& self) { when(self) << stamped([tag=self](acquired_cown<Customer> self) mutable { CustomerFactory::returned(self->factory, tag); }); }
 
-void Customer::wait(cown_ptr<Customer>& self) { when(self) << [](acquired_cown<Customer>) mutable {}; }
+void Customer::wait(cown_ptr<Customer>& self) { when(self) << stamped([](acquired_cown<Customer>) mutable {}); }
 
-void Customer::sit_down(cown_ptr<Customer>& self) { when(self) << [](acquired_cown<Customer>) mutable {}; }
+void Customer::sit_down(cown_ptr<Customer>& self) { when(self) << stamped([](acquired_cown<Customer>) mutable {}); }
 
-void Customer::pay_and_leave(cown_ptr<Customer>& self) { when(self) << [](acquired_cown<Customer> self) mutable { CustomerFactory::left(self->factory); }; }
+void Customer::pay_and_leave(cown_ptr<Customer>& self) { when(self) << stamped([](acquired_cown<Customer> self) mutable { CustomerFactory::left(self->factory); }); }
 
 };
 
@@ -160,4 +159,6 @@ struct SleepingBarber: public ActorBenchmark {
   inline static const std::string name = "Sleeping Barber";
 };
 
+static const bool sleepingbarber_registered = register_benchmark<SleepingBarber>(param<uint64_t>("haircuts", 5000), param<uint64_t>("room", 1000), param<uint64_t>("production", 1000), param<uint64_t>("cut", 1000));
+
 };
\ No newline at end of file
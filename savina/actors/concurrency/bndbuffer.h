@@ -61,7 +61,7 @@ struct Producer {
   Producer(cown_ptr<Manager>& manager, uint64_t items, uint64_t costs): last(0), items(items), manager(manager), costs(costs){}
 
   static void produce(cown_ptr<Producer>&& self) {
-    when(self) << [tag=self](acquired_cown<Producer> self) mutable {
+    when(self) << stamped([tag=self](acquired_cown<Producer> self) mutable {
       if (self->items > 0) {
         self->last = ItemProcessor(self->last, self->costs);
         Manager::data(self->manager, std::move(tag), self->last);
@@ -69,7 +69,7 @@ struct Producer {
       } else {
         Manager::exit(self->manager);
       }
-    };
+    });
   }
 };
 
@@ -81,35 +81,35 @@ struct Consumer {
   Consumer(cown_ptr<Manager>& manager, uint64_t costs): last(0), manager(manager), costs(costs) {}
 
   static void data(cown_ptr<Consumer>& self, double item) {
-    when(self) << [tag=self, item](acquired_cown<Consumer> self) mutable {
+    when(self) << stamped([tag=self, item](acquired_cown<Consumer> self) mutable {
       self->last = ItemProcessor(self->last + item, self->costs);
       Manager::available(self->manager, std::move(tag));
-    };
+    });
   }
 };
 
 void Manager::make(uint64_t buffersize, uint64_t producers, uint64_t consumers, uint64_t items, uint64_t producercosts, uint64_t consumercosts) {
   cown_ptr<Manager> self = make_cown<Manager>(buffersize, producers);
 
-  when(self) << [tag=self, producers, consumers, items, producercosts, consumercosts](acquired_cown<Manager> self)  mutable {
+  when(self) << stamped([tag=self, producers, consumers, items, producercosts, consumercosts](acquired_cown<Manager> self)  mutable {
     for (uint64_t i = 0; i < producers; i++)
       Producer::produce(make_cown<Producer>(tag, items, producercosts));
 
     self->max_consumers = consumers;
     for (uint64_t i = 0; i < consumers; i++)
       self->availableConsumers.emplace_back(make_cown<Consumer>(tag, consumercosts));
-  };
+  });
 }
 
 void Manager::complete() {
   if ((producer_count == 0) && (availableConsumers.size() == max_consumers)) {
     availableConsumers.clear();
-    return;
+    CompletionLatch::signal();
   }
 }
 
 void Manager::data(const cown_ptr<Manager>& self, cown_ptr<Producer> producer, double item) {
-  when(self) << [producer=std::move(producer), item](acquired_cown<Manager> self)  mutable {
+  when(self) << stamped([producer=std::move(producer), item](acquired_cown<Manager> self)  mutable {
     if (self->availableConsumers.empty()) {
       self->pendingData.emplace_back(std::make_tuple(producer, item));
     } else {
@@ -123,11 +123,11 @@ void Manager::data(const cown_ptr<Manager>& self, cown_ptr<Producer> producer, d
     } else {
       Producer::produce(std::move(producer));
     }
-  };
+  });
 }
 
 void Manager::available(const cown_ptr<Manager>& self, cown_ptr<Consumer> consumer) {
-  when(self) << [consumer=std::move(consumer)](acquired_cown<Manager> self)  mutable {
+  when(self) << stamped([consumer=std::move(consumer)](acquired_cown<Manager> self)  mutable {
     if (self->pendingData.empty()) {
       self->availableConsumers.emplace_back(std::move(consumer));
       self->complete();
@@ -144,14 +144,14 @@ void Manager::available(const cown_ptr<Manager>& self, cown_ptr<Consumer> consum
         Producer::produce(std::move(producer));
       }
     }
-  };
+  });
 }
 
 void Manager::exit(const cown_ptr<Manager>& self) {
-  when(self) << [](acquired_cown<Manager> self)  mutable {
+  when(self) << stamped([](acquired_cown<Manager> self)  mutable {
     self->producer_count--;
     self->complete();
-  };
+  });
 }
 
 };
@@ -174,4 +174,6 @@ struct BndBuffer: public ActorBenchmark {
   inline static const std::string name = "Bounded Buffer";
 };
 
+static const bool bndbuffer_registered = register_benchmark<BndBuffer>(param<uint64_t>("buffersize", 50), param<uint64_t>("producers", 40), param<uint64_t>("consumers", 40), param<uint64_t>("items", 1000), param<uint64_t>("producercosts", 25), param<uint64_t>("consumercosts", 25));
+
 };
\ No newline at end of file
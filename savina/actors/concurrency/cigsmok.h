@@ -30,39 +30,39 @@ struct Arbiter {
   Arbiter(uint64_t rounds): random(12345), rounds(rounds) {}
 
   static void add_smokers(const cown_ptr<Arbiter>& self, uint64_t num_smokers) {
-    when(self) << [tag=self, num_smokers](acquired_cown<Arbiter> self)  mutable{
+    when(self) << stamped([tag=self, num_smokers](acquired_cown<Arbiter> self)  mutable{
       for (uint64_t i = 0; i < num_smokers; ++i)
         self->smokers.emplace_back(make_cown<Smoker>(tag));
-    };
+    });
   }
 
   static void notify_smoker(const cown_ptr<Arbiter>& self) {
-    when(self) << [](acquired_cown<Arbiter> self)  mutable{
+    when(self) << stamped([](acquired_cown<Arbiter> self)  mutable{
       uint64_t index = self->random.nextInt() % self->smokers.size();
       Smoker::smoke(self->smokers[index], self->random.nextInt(1000) + 10);
-    };
+    });
   }
 
   static void started(const cown_ptr<Arbiter>& self) {
-    when(self) << [tag=self](acquired_cown<Arbiter> self)  mutable{
+    when(self) << stamped([tag=self](acquired_cown<Arbiter> self)  mutable{
       if (--self->rounds > 0) {
         Arbiter::notify_smoker(tag);
       } else {
         self->smokers.clear();
-        return;
+        CompletionLatch::signal();
       }
-    };
+    });
   }
 };
 
 void Smoker::smoke(const cown_ptr<Smoker>& self, uint64_t period) {
-  when(self) << [period](acquired_cown<Smoker> self)  mutable{
+  when(self) << stamped([period](acquired_cown<Smoker> self)  mutable{
     Arbiter::started(self->arbiter);
 
     for (uint64_t i = 0; i < period; ++i) {
       self->random.nextInt();
     }
-  };
+  });
 }
 
 };
@@ -82,4 +82,6 @@ struct Cigsmok: public ActorBenchmark {
   inline static const std::string name = "Cigarette Smokers";
 };
 
+static const bool cigsmok_registered = register_benchmark<Cigsmok>(param<uint64_t>("rounds", 1000), param<uint64_t>("smokers", 200));
+
 };
\ No newline at end of file
@@ -29,37 +29,42 @@ struct Dictionary {
   Dictionary() {}
   static void write(const cown_ptr<Dictionary>& self, cown_ptr<Worker> worker, uint64_t key, uint64_t value);
   static void read(const cown_ptr<Dictionary>& self, cown_ptr<Worker> worker, uint64_t key);
+  static void request(const cown_ptr<Dictionary>& self, bool write, uint64_t key, uint64_t intended);
 };
 
 struct Master {
   uint64_t workers;
-  Master(uint64_t workers): workers(workers) {}
+  cown_ptr<Dictionary> dictionary;
+  validation::Result<unordered_map<uint64_t, uint64_t>>::Completion finished;
+
+  Master(uint64_t workers, validation::Result<unordered_map<uint64_t, uint64_t>>::Completion finished): workers(workers), finished(finished) {}
 
-  static cown_ptr<Master> make(uint64_t workers, uint64_t messages, uint64_t percentage) {
-    auto master = make_cown<Master>(workers);
-    when(master) << [tag=master, workers, messages, percentage](acquired_cown<Master>)  mutable {
+  static cown_ptr<Master> make(uint64_t workers, uint64_t messages, uint64_t percentage, validation::Result<unordered_map<uint64_t, uint64_t>>::Completion finished) {
+    auto master = make_cown<Master>(workers, finished);
+    when(master) << stamped([tag=master, workers, messages, percentage](acquired_cown<Master> master)  mutable {
 
       auto dictionary = make_cown<Dictionary>();
+      master->dictionary = dictionary;
 
       for (uint64_t i = 0; i < workers; ++i) {
         Worker::work(make_cown<Worker>(tag, i, dictionary, messages, percentage));
       }
-    };
+    });
     return master;
   }
 
   static void done(const cown_ptr<Master>& self) {
-    when(self) << [](acquired_cown<Master> self)  mutable {
-      if (self->workers-- == 1) {
-        /* done */
+    when(self) << stamped([](acquired_cown<Master> self)  mutable {
+      if (self->workers-- == 1 && validation::wanted()) {
+        when(self->dictionary) << stamped([finished=self->finished](acquired_cown<Dictionary> dictionary) { finished(dictionary->map); });
       }
-    };
+    });
   }
 };
 
 void Worker::work(const cown_ptr<Worker>& self, uint64_t value) {
-  when(self) << [tag=self, value](acquired_cown<Worker> self)  mutable {
-    if (self->messages-- >= 1) {
+  when(self) << stamped([tag=self, value](acquired_cown<Worker> self)  mutable {
+    if (Throughput::more(self->messages-- >= 1)) {
       uint64_t value = self->random.nextInt(100);
       value %= (INT64_MAX / 4096);
 
@@ -71,21 +76,38 @@ void Worker::work(const cown_ptr<Worker>& self, uint64_t value) {
     } else {
       Master::done(self->master);
     }
-  };
+  });
 }
 
 void Dictionary::write(const cown_ptr<Dictionary>& self, cown_ptr<Worker> worker, uint64_t key, uint64_t value) {
-  when(self) << [worker=move(worker), key, value](acquired_cown<Dictionary> self) mutable {
+  when(self) << stamped([worker=move(worker), key, value](acquired_cown<Dictionary> self) mutable {
+    Throughput::completed();
     self->map[key] = value;
     Worker::work(worker, value);
-  };
+  });
 }
 
 void Dictionary::read(const cown_ptr<Dictionary>& self, cown_ptr<Worker> worker, uint64_t key) {
-  when(self) << [worker=move(worker), key](acquired_cown<Dictionary> self)  mutable {
+  when(self) << stamped([worker=move(worker), key](acquired_cown<Dictionary> self)  mutable {
+    Throughput::completed();
     auto it = self->map.find(key);
     Worker::work(worker, it != self->map.end() ? it->second : 0);
-  };
+  });
+}
+
+// An open-loop request from the --rate driver, answered without a Worker.
+void Dictionary::request(const cown_ptr<Dictionary>& self, bool write, uint64_t key, uint64_t intended) {
+  if (write) {
+    when(self) << stamped([key, intended](acquired_cown<Dictionary> self) mutable {
+      self->map[key] = key;
+      OpenLoop::respond(intended);
+    });
+  } else {
+    when(self) << stamped([key, intended](acquired_cown<Dictionary> self) mutable {
+      self->map.find(key);
+      OpenLoop::respond(intended);
+    });
+  }
 }
 
 };
@@ -94,17 +116,63 @@ struct Concdict: ActorBenchmark {
   uint64_t workers;
   uint64_t messages;
   uint64_t percentage;
+  // With --rate, the dictionary requests are sent to and the choice of
+  // request, both only used from the driver thread.
+  cown_ptr<concdict::Dictionary> dictionary;
+  SimpleRand random;
+  validation::Result<std::unordered_map<uint64_t, uint64_t>> contents;
 
   Concdict(uint64_t workers, uint64_t messages, uint64_t percentage):
-    workers(workers), messages(messages), percentage(percentage) {};
+    workers(workers), messages(messages), percentage(percentage), random(workers + messages + percentage) {};
 
   void run() {
     using namespace concdict;
-    Master::make(workers, messages, percentage);
+
+    if (OpenLoop::get().enabled) {
+      dictionary = make_cown<Dictionary>();
+      return;
+    }
+
+    Master::make(workers, messages, percentage, contents.completion());
+  }
+
+  bool continuous() { return true; }
+
+  bool open_loop() { return true; }
+
+  void request(uint64_t intended) {
+    uint64_t value = random.nextInt(100);
+    concdict::Dictionary::request(dictionary, value < percentage, value, intended);
+  }
+
+  void finish() {
+    dictionary = nullptr;
+  }
+
+  bool validates() { return true; }
+
+  // Replays each worker's requests; every write stores its key as the value.
+  std::string validate() {
+    std::unordered_map<uint64_t, uint64_t> expected;
+    for (uint64_t i = 0; i < workers; ++i) {
+      SimpleRand random(i + messages + percentage);
+      for (uint64_t m = 0; m < messages; ++m) {
+        uint64_t value = random.nextInt(100);
+        if (value < percentage)
+          expected[value] = value;
+      }
+    }
+
+    if (contents.value && contents.value->size() == expected.size() && *contents.value != expected)
+      return "dictionary contents differ";
+
+    return validation::expect("dictionary size", contents.value ? std::optional<size_t>(contents.value->size()) : std::nullopt, expected.size());
   }
 
   inline static const std::string name = "Concurrent Dictionary";
 
 };
 
+static const bool concdict_registered = register_benchmark<Concdict>(param<uint64_t>("workers", 20), param<uint64_t>("messages", 10000), param<uint64_t>("percentage", 10));
+
 };
\ No newline at end of file
@@ -54,22 +54,22 @@ struct SortedList {
   SortedLinkedList<uint64_t> data;
 
   static void write(const cown_ptr<SortedList>& self, const cown_ptr<Worker> worker, uint64_t value) {
-    when(self) << [worker=move(worker), value](acquired_cown<SortedList> self)  mutable {
+    when(self) << stamped([worker=move(worker), value](acquired_cown<SortedList> self)  mutable {
       self->data.push(value);
       Worker::work(worker, value);
-    };
+    });
   }
 
   static void contains(const cown_ptr<SortedList>& self, const cown_ptr<Worker> worker, uint64_t value) {
-    when(self) << [worker=move(worker), value](acquired_cown<SortedList> self)  mutable {
+    when(self) << stamped([worker=move(worker), value](acquired_cown<SortedList> self)  mutable {
       Worker::work(worker, self->data.contains(value) ? 0 : 1);
-    };
+    });
   }
 
   static void size(const cown_ptr<SortedList>& self, const cown_ptr<Worker> worker) {
-    when(self) << [worker=move(worker)](acquired_cown<SortedList> self)  mutable {
+    when(self) << stamped([worker=move(worker)](acquired_cown<SortedList> self)  mutable {
       Worker::work(worker, self->data.size());
-    };
+    });
   }
 };
 
@@ -93,16 +93,15 @@ struct Master {
   }
 
   static void done(const cown_ptr<Master>& self) {
-    when(self) << [](acquired_cown<Master> self)  mutable {
-      if (--self->workers == 0) {
-        /* done */
-      }
-    };
+    when(self) << stamped([](acquired_cown<Master> self)  mutable {
+      if (--self->workers == 0)
+        CompletionLatch::signal();
+    });
   }
 };
 
 void Worker::work(const cown_ptr<Worker>& self, uint64_t value) {
-  when(self) << [value](acquired_cown<Worker> self)  mutable {
+  when(self) << stamped([value](acquired_cown<Worker> self)  mutable {
     if (--self->messages > 0) {
       uint64_t value2 = self->random.nextInt(100);
 
@@ -116,7 +115,7 @@ void Worker::work(const cown_ptr<Worker>& self, uint64_t value) {
     } else {
       Master::done(self->master);
     }
-  };
+  });
 }
 
 };
@@ -138,5 +137,7 @@ struct Concsll: public ActorBenchmark {
   inline static const std::string name = "Concurrent Sorted Linked-List";
 };
 
+static const bool concsll_registered = register_benchmark<Concsll>(param<uint64_t>("workers", 20), param<uint64_t>("messages", 8000), param<uint64_t>("size", 1), param<uint64_t>("write", 10));
+
 
 };
@@ -38,9 +38,9 @@ struct SeriesWorker {
 };
 
 void RateComputer::compute(const cown_ptr<RateComputer>& self, cown_ptr<SeriesWorker> worker, double term) {
-  when(self) << [worker=move(worker), term](acquired_cown<RateComputer> self)  mutable {
+  when(self) << stamped([worker=move(worker), term](acquired_cown<RateComputer> self)  mutable {
     SeriesWorker::result(worker, self->rate * term * (1 - term));
-  };
+  });
 }
 
 struct LogmapMaster {
@@ -49,23 +49,24 @@ struct LogmapMaster {
   uint64_t requested;
   uint64_t received;
   double sum;
+  validation::Result<double>::Completion done;
 
-  LogmapMaster(uint64_t terms): terms(terms), requested(0), received(0), sum(0) {}
+  LogmapMaster(uint64_t terms, validation::Result<double>::Completion done): terms(terms), requested(0), received(0), sum(0), done(done) {}
 
-  static cown_ptr<LogmapMaster> make(uint64_t terms, uint64_t series, double rate, double increment) {
-    cown_ptr<LogmapMaster> master = make_cown<LogmapMaster>(terms);
-    when(master) << [tag=master,terms, series, rate, increment](acquired_cown<LogmapMaster> master)  mutable {
+  static cown_ptr<LogmapMaster> make(uint64_t terms, uint64_t series, double rate, double increment, validation::Result<double>::Completion done) {
+    cown_ptr<LogmapMaster> master = make_cown<LogmapMaster>(terms, done);
+    when(master) << stamped([tag=master,terms, series, rate, increment](acquired_cown<LogmapMaster> master)  mutable {
       for (uint64_t j = 0; j < series; ++j) {
         double start_term = (double)j * increment;
         master->workers.emplace_back(make_cown<SeriesWorker>(tag, make_cown<RateComputer>(rate + start_term), start_term));
 
       }
-    };
+    });
     return master;
   }
 
   static void start(const cown_ptr<LogmapMaster>& self) {
-    when(self) << [](acquired_cown<LogmapMaster> self)  mutable {
+    when(self) << stamped([](acquired_cown<LogmapMaster> self)  mutable {
       for(uint64_t i = 0; i < self->terms; ++i)
         for(uint64_t j = 0; j < self->workers.size(); ++j)
           SeriesWorker::next(self->workers[j]);
@@ -74,19 +75,32 @@ struct LogmapMaster {
         SeriesWorker::get(self->workers[k]);
         self->requested++;
       }
-    };
+    });
   }
 
   static void result(const cown_ptr<LogmapMaster>& self, double term) {
-    when(self) << [term](acquired_cown<LogmapMaster> self)  mutable {
+    when(self) << stamped([term](acquired_cown<LogmapMaster> self)  mutable {
       self->sum += term;
       self->received++;
       if(self->received == self->requested) {
         self->workers.clear();
-        // std::cout << self->sum << std::endl;
-        /* done */
+        self->done(self->sum);
       }
-    };
+    });
+  }
+
+  static double sequential(uint64_t terms, uint64_t series, double rate, double increment) {
+    double sum = 0;
+
+    for (uint64_t j = 0; j < series; ++j) {
+      double term = (double)j * increment;
+      double series_rate = rate + term;
+      for (uint64_t i = 0; i < terms; ++i)
+        term = series_rate * term * (1 - term);
+      sum += term;
+    }
+
+    return sum;
   }
 };
 
@@ -117,33 +131,33 @@ bool SeriesWorker::unstash(cown_ptr<SeriesWorker> self, double term) {
 
 
 void SeriesWorker::next(const cown_ptr<SeriesWorker>& self) {
-  when(self) << [tag=self](acquired_cown<SeriesWorker> self)  mutable {
+  when(self) << stamped([tag=self](acquired_cown<SeriesWorker> self)  mutable {
     if (self->stash_mode) {
       self->stash(StashedMessage::NextMessage);
     } else {
       RateComputer::compute(self->computer, move(tag), self->term);
       self->stash_mode = true;
     }
-  };
+  });
 }
 
 void SeriesWorker::result(const cown_ptr<SeriesWorker>& self, double term) {
-  when(self) << [tag=self, term](acquired_cown<SeriesWorker> self)  mutable {
+  when(self) << stamped([tag=self, term](acquired_cown<SeriesWorker> self)  mutable {
     self->term = term;
     if (self->stash_mode) {
       self->stash_mode = self->unstash(move(tag), term);
     }
-  };
+  });
 }
 
 void SeriesWorker::get(const cown_ptr<SeriesWorker>& self) {
-  when(self) << [](acquired_cown<SeriesWorker> self)  mutable {
+  when(self) << stamped([](acquired_cown<SeriesWorker> self)  mutable {
     if (self->stash_mode) {
       self->stash(StashedMessage::GetMessage);
     } else {
       LogmapMaster::result(self->master, self->term);
     }
-  };
+  });
 }
 
 };
@@ -153,18 +167,27 @@ struct Logmap: public ActorBenchmark {
   uint64_t series;
   double rate;
   double increment;
+  validation::Result<double> sum;
 
   Logmap(uint64_t terms, uint64_t series, double rate, double increment): terms(terms), series(series), rate(rate), increment(increment) {}
 
   void run() {
     using namespace logmap;
-    LogmapMaster::start(LogmapMaster::make(terms, series, rate, increment));
+    LogmapMaster::start(LogmapMaster::make(terms, series, rate, increment, sum.completion()));
+  }
+
+  bool validates() { return true; }
+
+  std::string validate() {
+    return validation::expect_near("sum", sum.value, logmap::LogmapMaster::sequential(terms, series, rate, increment));
   }
 
   inline static const std::string name = "Logistic Map Series";
 
 };
 
+static const bool logmap_registered = register_benchmark<Logmap>(param<uint64_t>("terms", 25000), param<uint64_t>("series", 10), param<double>("rate", 3.64), param<double>("increment", 0.0025));
+
 };
 
 
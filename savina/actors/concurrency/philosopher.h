@@ -36,7 +36,7 @@ struct Arbitator {
   }
 
   static void hungry(const cown_ptr<Arbitator>& self, cown_ptr<Philosopher> philosopher, uint64_t id) {
-    when(self) << [philosopher=move(philosopher), id](acquired_cown<Arbitator> self)  mutable {
+    when(self) << stamped([philosopher=move(philosopher), id](acquired_cown<Arbitator> self)  mutable {
       uint64_t right_index = ((id + 1) % self->philosophers);
       if (self->forks[id] || self->forks[right_index]) {
         Philosopher::denied(philosopher);
@@ -45,40 +45,39 @@ struct Arbitator {
         self->forks[right_index] = true;
         Philosopher::eat(philosopher);
       }
-    };
+    });
   }
 
   static void done(const cown_ptr<Arbitator>& self, uint64_t id) {
-    when(self) << [id](acquired_cown<Arbitator> self)  mutable {
+    when(self) << stamped([id](acquired_cown<Arbitator> self)  mutable {
       self->forks[id] = false;
       self->forks[(id + 1) % self->philosophers] = false;
-    };
+    });
   }
 
   static void finished(const cown_ptr<Arbitator>& self) {
-    when(self) << [](acquired_cown<Arbitator> self)  mutable {
-      if (--(self->done_eating) == 0) {
-        return;
-      }
-    };
+    when(self) << stamped([](acquired_cown<Arbitator> self)  mutable {
+      if (--(self->done_eating) == 0)
+        CompletionLatch::signal();
+    });
   }
 };
 
 void Philosopher::start(const cown_ptr<Philosopher>& self) {
-  when(self) << [tag=self](acquired_cown<Philosopher> self)  mutable {
+  when(self) << stamped([tag=self](acquired_cown<Philosopher> self)  mutable {
     Arbitator::hungry(self->arbitator, move(tag), self->id);
-  };
+  });
 }
 
 void Philosopher::denied(const cown_ptr<Philosopher>& self) {
-  when(self) << [tag=self](acquired_cown<Philosopher> self)  mutable {
+  when(self) << stamped([tag=self](acquired_cown<Philosopher> self)  mutable {
     self->local++;
     Arbitator::hungry(self->arbitator, move(tag), self->id);
-  };
+  });
 }
 
 void Philosopher::eat(const cown_ptr<Philosopher>& self) {
-  when(self) << [tag=self](acquired_cown<Philosopher> self)  mutable {
+  when(self) << stamped([tag=self](acquired_cown<Philosopher> self)  mutable {
     Arbitator::done(self->arbitator, self->id);
 
     if (--self->rounds >= 1) {
@@ -86,7 +85,7 @@ void Philosopher::eat(const cown_ptr<Philosopher>& self) {
     } else {
       Arbitator::finished(self->arbitator);
     }
-  };
+  });
 }
 
 };
@@ -116,4 +115,6 @@ struct DiningPhilosophers: public ActorBenchmark {
   inline static const std::string name = "Dining Philosophers";
 };
 
+static const bool diningphilosophers_registered = register_benchmark<DiningPhilosophers>(param<uint64_t>("philosophers", 20), param<uint64_t>("rounds", 10000), param<uint64_t>("channels", 1));
+
 };
\ No newline at end of file
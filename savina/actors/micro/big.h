@@ -23,23 +23,23 @@ struct BigActor {
     : master(move(master)), index(index), random(index), pings(pings), sent(0) {}
 
   static void set_neighbors(const cown_ptr<BigActor>& self, vector<cown_ptr<BigActor>> n) {
-    when(self) << [n=move(n)](acquired_cown<BigActor> self) mutable {
+    when(self) << stamped([n=move(n)](acquired_cown<BigActor> self) mutable {
       self->neighbors = move(n);
-    };
+    });
   }
 
   static void ping(const cown_ptr<BigActor>& self, int64_t sender) {
-    when(self) << [sender](acquired_cown<BigActor> self) mutable {
+    when(self) << stamped([sender](acquired_cown<BigActor> self) mutable {
       BigActor::pong(self->neighbors[sender], self->index);
-    };
+    });
   }
 
   static void pong(const cown_ptr<BigActor>& self, int64_t n);
 
   static void cleanup(const cown_ptr<BigActor>& self) {
-    when(self) << [](acquired_cown<BigActor> self) mutable {
+    when(self) << stamped([](acquired_cown<BigActor> self) mutable {
       self->neighbors.clear();
-    };
+    });
   }
 };
 
@@ -54,7 +54,7 @@ struct BigMaster {
   static void make(uint64_t pings, uint64_t actors) {
     cown_ptr<BigMaster> master = make_cown<BigMaster>(actors);
 
-    when(master) << [tag=move(master), pings, actors](acquired_cown<BigMaster> master) {
+    when(master) << stamped([tag=move(master), pings, actors](acquired_cown<BigMaster> master) {
       for (uint64_t i = 0; i < actors; ++i)
         master->n.emplace_back(make_cown<BigActor>(tag, i, pings));
 
@@ -65,22 +65,23 @@ struct BigMaster {
       for (const cown_ptr<BigActor>& big: master->n) {
         BigActor::pong(big, -1);
       }
-    };
+    });
   }
 
   static void done(const cown_ptr<BigMaster>& self) {
-    when(self) << [](acquired_cown<BigMaster> self)  mutable{
+    when(self) << stamped([](acquired_cown<BigMaster> self)  mutable{
       if(--self->actors == 0) {
+        CompletionLatch::signal();
         for (const cown_ptr<BigActor>& actor: self->n)
           BigActor::cleanup(actor);
         self->n.clear();
       }
-    };
+    });
   }
 };
 
 void BigActor::pong(const cown_ptr<BigActor>& self, int64_t n) {
-  when(self) << [n](acquired_cown<BigActor> self) mutable{
+  when(self) << stamped([n](acquired_cown<BigActor> self) mutable{
     if (self->sent < self->pings) {
       uint64_t index = self->random.nextInt(self->neighbors.size());
       BigActor::ping(self->neighbors[index], self->index);
@@ -88,7 +89,7 @@ void BigActor::pong(const cown_ptr<BigActor>& self, int64_t n) {
     } else {
       BigMaster::done(self->master);
     }
-  };
+  });
 }
 
 };
@@ -106,6 +107,8 @@ struct Big: ActorBenchmark {
   inline static const std::string name = "Big";
 };
 
+static const bool big_registered = register_benchmark<Big>(param<uint64_t>("pings", 20000), param<uint64_t>("actors", 120));
+
 };
 
 
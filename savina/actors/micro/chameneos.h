@@ -52,41 +52,43 @@ struct Mall {
   uint64_t meeting_count;
   uint64_t sum;
   cown_ptr<Chameneo> waiting;
+  validation::Result<uint64_t>::Completion done;
 
-  Mall(uint64_t meetings, uint64_t chameneos)
-    : chameneos(chameneos), faded(0), meeting_count(meetings), sum(0) {}
+  Mall(uint64_t meetings, uint64_t chameneos, validation::Result<uint64_t>::Completion done)
+    : chameneos(chameneos), faded(0), meeting_count(meetings), sum(0), done(done) {}
 
-  static void make(uint64_t meetings, uint64_t chameneos) {
-    cown_ptr<Mall> mall = make_cown<Mall>(meetings, chameneos);
+  static void make(uint64_t meetings, uint64_t chameneos, validation::Result<uint64_t>::Completion done) {
+    cown_ptr<Mall> mall = make_cown<Mall>(meetings, chameneos, done);
     for (uint64_t i = 0; i < chameneos; ++i)
       Chameneo::make(mall, Color::factory(i % 3));
   }
 
   static void meetings(const cown_ptr<Mall>& self, uint64_t count) {
-    when(self) << [count](acquired_cown<Mall> self)  mutable{
+    when(self) << stamped([count](acquired_cown<Mall> self)  mutable{
       self->faded++;
       self->sum += count;
 
       if (self->faded == self->chameneos) {
-        /* done */
+        self->done(self->sum);
       }
-    };
+    });
   }
 
   static void meet(const cown_ptr<Mall>& self, cown_ptr<Chameneo> approaching, ChameneoColor color) {
-    when(self) << [approaching=move(approaching), color](acquired_cown<Mall> self)  mutable{
-      if (self->meeting_count > 0) {
+    when(self) << stamped([approaching=move(approaching), color](acquired_cown<Mall> self)  mutable{
+      if (Throughput::more(self->meeting_count > 0)) {
         if(!self->waiting) {
           self->waiting = move(approaching);
         } else {
           self->meeting_count--;
+          Throughput::completed();
           Chameneo::meet(self->waiting, move(approaching), color);
           self->waiting = nullptr; // cown_ptr<Chameneo>();
         }
       } else {
         Chameneo::report(approaching);
       }
-    };
+    });
   }
 };
 
@@ -95,27 +97,27 @@ void Chameneo::make(const cown_ptr<Mall>& mall, ChameneoColor color) {
 }
 
 void Chameneo::meet(const cown_ptr<Chameneo>& self, cown_ptr<Chameneo> approaching, ChameneoColor color) {
-  when(self) << [tag=self, approaching=move(approaching), color](acquired_cown<Chameneo> self)  mutable{
+  when(self) << stamped([tag=self, approaching=move(approaching), color](acquired_cown<Chameneo> self)  mutable{
     self->color = Color::complement(self->color, color);
     self->meeting_count++;
     Chameneo::change(approaching, self->color);
     Mall::meet(self->mall, tag, self->color);
-  };
+  });
 }
 
 void Chameneo::change(const cown_ptr<Chameneo>& self, ChameneoColor color) {
-  when(self) << [tag=self, color](acquired_cown<Chameneo> self)  mutable{
+  when(self) << stamped([tag=self, color](acquired_cown<Chameneo> self)  mutable{
     self->color = color;
     self->meeting_count++;
     Mall::meet(self->mall, move(tag), self->color);
-  };
+  });
 }
 
 void Chameneo::report(const cown_ptr<Chameneo>& self) {
-  when(self) << [tag=self](acquired_cown<Chameneo> self)  mutable{
+  when(self) << stamped([tag=self](acquired_cown<Chameneo> self)  mutable{
     Mall::meetings(self->mall, self->meeting_count);
     self->color = ChameneoColor::Faded;
-  };
+  });
 }
 
 };
@@ -123,12 +125,22 @@ void Chameneo::report(const cown_ptr<Chameneo>& self) {
 struct Chameneos: public ActorBenchmark {
   uint64_t meetings;
   uint64_t chameneos;
+  validation::Result<uint64_t> met;
 
   Chameneos(uint64_t chameneos, uint64_t meetings): meetings(meetings), chameneos(chameneos) {}
 
-  void run() { chameneos::Mall::make(meetings, chameneos); }
+  void run() { chameneos::Mall::make(meetings, chameneos, met.completion()); }
+
+  bool continuous() { return true; }
+
+  bool validates() { return true; }
+
+  // Each meeting is counted by both chameneos that took part.
+  std::string validate() { return validation::expect("meetings counted", met.value, 2 * meetings); }
 
   inline static const std::string name = "Chameneos";
 };
 
+static const bool chameneos_registered = register_benchmark<Chameneos>(param<uint64_t>("chameneos", 100), param<uint64_t>("meetings", 200000));
+
 };
\ No newline at end of file
@@ -18,43 +18,51 @@ struct Counter {
 
 struct Producer {
   uint64_t messages;
+  validation::Result<uint64_t>::Completion done;
 
-  Producer(uint64_t messages): messages(messages) { }
+  Producer(uint64_t messages, validation::Result<uint64_t>::Completion done): messages(messages), done(done) { }
 
-  static void make(const cown_ptr<Counter>& counter, uint64_t messages) {
+  static void make(const cown_ptr<Counter>& counter, uint64_t messages, validation::Result<uint64_t>::Completion done) {
     for (uint64_t i = 0; i < messages; ++i) {
       Counter::increment(counter);
     }
 
-    Counter::retrieve(counter, make_cown<Producer>(messages));
+    Counter::retrieve(counter, make_cown<Producer>(messages, done));
   }
 
   static void result(const cown_ptr<Producer>& self, uint64_t result) {
-    when(self) << [](acquired_cown<Producer> self) mutable {
-      /* done */
-    };
+    when(self) << stamped([result](acquired_cown<Producer> self) mutable {
+      self->done(result);
+    });
   }
 };
 
 void Counter::increment(const cown_ptr<Counter>& self) {
-  when(self) << [](acquired_cown<Counter> self)  mutable { self->count++; };
+  when(self) << stamped([](acquired_cown<Counter> self)  mutable { self->count++; });
 }
 
 void Counter::retrieve(const cown_ptr<Counter>& self, cown_ptr<Producer> sender) {
-  when(self) << [sender=move(sender)](acquired_cown<Counter> self)  mutable { Producer::result(sender, self->count); };
+  when(self) << stamped([sender=move(sender)](acquired_cown<Counter> self)  mutable { Producer::result(sender, self->count); });
 }
 
 };
 
 struct Count: ActorBenchmark {
   uint64_t messages;
+  validation::Result<uint64_t> result;
 
   Count(uint64_t messages): messages(messages) {}
 
-  void run() { count::Producer::make(make_cown<count::Counter>(), messages); }
+  void run() { count::Producer::make(make_cown<count::Counter>(), messages, result.completion()); }
+
+  bool validates() { return true; }
+
+  std::string validate() { return validation::expect("count", result.value, messages); }
 
   inline static const std::string name = "Count";
 
 };
 
+static const bool count_registered = register_benchmark<Count>(param<uint64_t>("messages", 1000000));
+
 };
\ No newline at end of file
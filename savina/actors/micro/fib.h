@@ -16,29 +16,33 @@ struct Fibonacci {
   cown_ptr<Fibonacci> parent;
   uint64_t responses;
   uint64_t result;
+  // Only set on the root, which has no parent to respond to.
+  validation::Result<uint64_t>::Completion done;
 
   Fibonacci(): responses(0), result(0) {}
 
+  Fibonacci(validation::Result<uint64_t>::Completion done): responses(0), result(0), done(done) {}
+
   Fibonacci(cown_ptr<Fibonacci> parent): parent(move(parent)), responses(0), result(0) {}
 
-  static void root(int64_t n) { Fibonacci::compute(make_cown<Fibonacci>(), n); }
+  static void root(int64_t n, validation::Result<uint64_t>::Completion done) { Fibonacci::compute(make_cown<Fibonacci>(done), n); }
 
   static void request(cown_ptr<Fibonacci>& parent, int64_t n) {
     Fibonacci::compute(make_cown<Fibonacci>(parent), n);
   }
 
   static void response(cown_ptr<Fibonacci>& self, uint64_t n) {
-    when(self) << [n](acquired_cown<Fibonacci> self)  mutable {
+    when(self) << stamped([n](acquired_cown<Fibonacci> self)  mutable {
       self->result += n;
       self->responses++;
 
       if (self->responses == 2)
         self->propagate();
-    };
+    });
   }
 
   static void compute(cown_ptr<Fibonacci>&& self, int64_t n) {
-    when(self) << [tag=self, n](acquired_cown<Fibonacci> self) mutable {
+    when(self) << stamped([tag=self, n](acquired_cown<Fibonacci> self) mutable {
       if (n <= 2) {
         self->result = 1;
         self->propagate();
@@ -46,12 +50,22 @@ struct Fibonacci {
         Fibonacci::request(tag, n-1);
         Fibonacci::request(tag, n-2);
       }
-    };
+    });
+  }
+
+  static uint64_t sequential(uint64_t n) {
+    uint64_t previous = 1;
+    uint64_t current = 1;
+    for (uint64_t i = 2; i < n; i++)
+      previous = std::exchange(current, current + previous);
+    return current;
   }
 
   void propagate() {
     if (parent)
       Fibonacci::response(parent, result);
+    else
+      done(result);
   }
 
 };
@@ -60,14 +74,23 @@ struct Fibonacci {
 
 struct Fib: public ActorBenchmark {
   uint64_t index;
+  validation::Result<uint64_t> result;
 
   Fib(uint64_t index): index(index) {}
 
-  void run() { fib::Fibonacci::root(index); }
+  void run() { fib::Fibonacci::root(index, result.completion()); }
+
+  bool validates() { return true; }
+
+  std::string validate() {
+    return validation::expect("fib(" + std::to_string(index) + ")", result.value, fib::Fibonacci::sequential(index));
+  }
 
   inline static const std::string name = "Fib";
 
 };
 
+static const bool fib_registered = register_benchmark<Fib>(param<uint64_t>("index", 25));
+
 
 };
\ No newline at end of file
@@ -21,11 +21,11 @@ struct ForkJoinMaster {
 
 struct ForkJoin {
   static void make(const cown_ptr<ForkJoinMaster>& master, Token token) {
-    when(make_cown<ForkJoin>()) << [master](acquired_cown<ForkJoin>) mutable {
+    when(make_cown<ForkJoin>()) << stamped([master](acquired_cown<ForkJoin>) mutable {
       double n = sin(double(37.2));
       double r = n * n;
       ForkJoinMaster::done(master);
-    };
+    });
   }
 };
 
@@ -38,9 +38,10 @@ void ForkJoinMaster::make(uint64_t workers) {
 }
 
 void ForkJoinMaster::done(const cown_ptr<ForkJoinMaster>& self) {
-  when(self) << [](acquired_cown<ForkJoinMaster> self)  mutable{
-    self->workers--;
-  };
+  when(self) << stamped([](acquired_cown<ForkJoinMaster> self)  mutable{
+    if (--self->workers == 0)
+      CompletionLatch::signal();
+  });
 }
 
 };
@@ -55,4 +56,6 @@ struct Fjcreate: public ActorBenchmark {
   inline static const std::string name = "Fork-Join Create";
 };
 
+static const bool fjcreate_registered = register_benchmark<Fjcreate>(param<uint64_t>("workers", 40000));
+
 };
\ No newline at end of file
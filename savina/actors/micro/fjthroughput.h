@@ -43,18 +43,18 @@ struct FjthrMaster {
   }
 
   static void done(const cown_ptr<FjthrMaster>& self) {
-    when(self) << [](acquired_cown<FjthrMaster> self)  mutable{
-      if (--self->total == 0) { /* done */ }
-    };
+    when(self) << stamped([](acquired_cown<FjthrMaster> self)  mutable{
+      if (--self->total == 0) CompletionLatch::signal();
+    });
   }
 };
 
 void Throughput::compute(const cown_ptr<Throughput>& self) {
-  when(self) << [](acquired_cown<Throughput> self)  mutable{
+  when(self) << stamped([](acquired_cown<Throughput> self)  mutable{
     double n = sin(37.2);
     double r = n * n;
     FjthrMaster::done(self->master);
-  };
+  });
 }
 
 };
@@ -73,4 +73,6 @@ struct Fjthrput: public ActorBenchmark {
   inline static const std::string name = "Fork-Join Throughput";
 };
 
+static const bool fjthrput_registered = register_benchmark<Fjthrput>(param<uint64_t>("messages", 10000), param<uint64_t>("actors", 60), param<uint64_t>("channels", 1), param<bool>("priorities", true));
+
 };
\ No newline at end of file
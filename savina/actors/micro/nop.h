@@ -6,13 +6,18 @@
 
 namespace actor_benchmark {
 
+// Starts and stops the runtime with nothing to do, the baseline for the BoC
+// Startup benchmarks.
 struct Nop: public ActorBenchmark {
   Nop() {}
 
-  void run() { }
+  // There is nothing to wait for.
+  void run() { CompletionLatch::signal(); }
 
   inline static const std::string name = "Nop";
 
 };
 
+static const bool nop_registered = register_benchmark<Nop>();
+
 }
\ No newline at end of file
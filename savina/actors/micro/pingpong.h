@@ -19,42 +19,53 @@ struct Pong {
 struct Ping {
   uint64_t left;
   cown_ptr<Pong> _pong;
+  validation::Result<uint64_t>::Completion done;
 
-  Ping(uint64_t pings, const cown_ptr<Pong>& pong): left(pings - 1), _pong(pong) {}
+  Ping(uint64_t pings, const cown_ptr<Pong>& pong, validation::Result<uint64_t>::Completion done): left(pings - 1), _pong(pong), done(done) {}
 
-  static void make(uint64_t pings, cown_ptr<Pong> pong) {
-    Pong::ping(pong, make_cown<Ping>(pings, pong));
+  static void make(uint64_t pings, cown_ptr<Pong> pong, validation::Result<uint64_t>::Completion done) {
+    Pong::ping(pong, make_cown<Ping>(pings, pong, done));
   }
 
   static void pong(const cown_ptr<Ping>& self) {
-    when(self) << [tag=self](acquired_cown<Ping> self)  mutable{
-      if(self->left > 0) {
+    when(self) << stamped([tag=self](acquired_cown<Ping> self)  mutable{
+      Throughput::completed();
+      if(Throughput::more(self->left > 0)) {
         Pong::ping(self->_pong, move(tag));
         self->left--;
-      } else {
-        /* done */
+      } else if (validation::wanted()) {
+        when(self->_pong) << stamped([done=self->done](acquired_cown<Pong> pong) { done(pong->count); });
       }
-    };
+    });
   }
 };
 
 void Pong::ping(const cown_ptr<Pong>& self, cown_ptr<Ping> sender) {
-  when(self) << [sender=move(sender)](acquired_cown<Pong> self)  mutable{
+  when(self) << stamped([sender=move(sender)](acquired_cown<Pong> self)  mutable{
     Ping::pong(sender);
     self->count++;
-  };
+  });
 }
 
 };
 
 struct PingPong: public ActorBenchmark {
   uint64_t pings;
+  validation::Result<uint64_t> received;
 
   PingPong(uint64_t pings): pings(pings) {}
 
-  void run() { pingpong::Ping::make(pings, make_cown<pingpong::Pong>()); }
+  void run() { pingpong::Ping::make(pings, make_cown<pingpong::Pong>(), received.completion()); }
+
+  bool continuous() { return true; }
+
+  bool validates() { return true; }
+
+  std::string validate() { return validation::expect("pings received", received.value, pings); }
 
   inline static const std::string name = "Ping Pong";
 };
 
+static const bool pingpong_registered = register_benchmark<PingPong>(param<uint64_t>("pings", 40000));
+
 };
\ No newline at end of file
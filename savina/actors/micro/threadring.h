@@ -16,21 +16,22 @@ struct RingActor {
   RingActor(const cown_ptr<RingActor>& next): _next(next) {}
 
   static void next(const cown_ptr<RingActor>& self, cown_ptr<RingActor> neighbor) {
-    when(self) << [neighbor=move(neighbor)](acquired_cown<RingActor> self)  mutable{
+    when(self) << stamped([neighbor=move(neighbor)](acquired_cown<RingActor> self)  mutable{
       self->_next = move(neighbor);
-    };
+    });
   }
 
   static void pass(const cown_ptr<RingActor>& self, uint64_t left) {
-    when(self) << [left](acquired_cown<RingActor> self)  mutable{
-      if (left > 0) {
+    when(self) << stamped([left](acquired_cown<RingActor> self)  mutable{
+      Throughput::completed();
+      if (Throughput::more(left > 0)) {
         // assert(self->_next != nullptr); FIXME
         RingActor::pass(self->_next, left - 1);
       } else {
         self->_next = nullptr;
-        /* done */
+        CompletionLatch::signal();
       }
-    };
+    });
   }
 };
 
@@ -60,8 +61,12 @@ struct ThreadRing: public ActorBenchmark {
     }
   }
 
+  bool continuous() { return true; }
+
   inline static const std::string name = "Thread Ring";
 };
 
+static const bool threadring_registered = register_benchmark<ThreadRing>(param<uint64_t>("actors", 100), param<uint64_t>("pass", 100000));
+
 };
 
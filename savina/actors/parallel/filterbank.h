@@ -35,14 +35,14 @@ struct Producer {
   Producer(uint64_t simulations): simulations(simulations), sent(0) {}
 
   static void next(const cown_ptr<Producer>& self, cown_ptr<Source> source) {
-    when(self) << [source=move(source)](acquired_cown<Producer> self)  mutable {
+    when(self) << stamped([source=move(source)](acquired_cown<Producer> self)  mutable {
       if (self->sent < self->simulations) {
         Source::boot(source);
         self->sent++;
       } else {
         // complete
       }
-    };
+    });
   }
 };
 
@@ -53,9 +53,9 @@ struct Sink {
   Sink(uint64_t sinkrate): sinkrate(sinkrate), count(0) {};
 
   static void value(const cown_ptr<Sink>& self, uint64_t n) {
-    when(self) << [n](acquired_cown<Sink> self)  mutable {
+    when(self) << stamped([n](acquired_cown<Sink> self)  mutable {
       self->count = (self->count + 1) % self->sinkrate;
-    };
+    });
   }
 };
 
@@ -65,7 +65,7 @@ struct Combine {
   Combine(const cown_ptr<Sink>& sink): sink(sink) {}
 
   static void collect(const cown_ptr<Combine>& self, unique_ptr<unordered_map<uint64_t, uint64_t>> map) {
-    when(self) << [map=std::move(map)](acquired_cown<Combine> self)  mutable {
+    when(self) << stamped([map=std::move(map)](acquired_cown<Combine> self)  mutable {
       uint64_t sum = 0;
 
       for (auto item : *map) {
@@ -73,7 +73,7 @@ struct Combine {
       }
 
       Sink::value(self->sink, sum);
-    };
+    });
   }
 };
 
@@ -85,7 +85,7 @@ struct Integrator {
   Integrator(uint64_t channels, cown_ptr<Combine> combine): channels(channels), combine(move(combine)) {}
 
   static void value(const cown_ptr<Integrator>& self, uint64_t id, uint64_t n) {
-    when(self) << [id, n](acquired_cown<Integrator> self) mutable {
+    when(self) << stamped([id, n](acquired_cown<Integrator> self) mutable {
       bool processed = false;
       uint64_t size = self->data.size();
       uint64_t i = 0;
@@ -112,7 +112,7 @@ struct Integrator {
         self->data.pop_front();
         Combine::collect(self->combine, move(first));
       }
-    };
+    });
   }
 };
 
@@ -148,11 +148,11 @@ struct Delay {
   Delay(uint64_t length, const cown_ptr<FirFilter> filter): length(length), filter(move(filter)), state(length, 0), placeholder(0) {}
 
   static void value(const cown_ptr<Delay>& self, uint64_t n) {
-    when(self) << [n](acquired_cown<Delay> self)  mutable {
+    when(self) << stamped([n](acquired_cown<Delay> self)  mutable {
       FirFilter::value(self->filter, self->state[self->placeholder]);
       self->state[self->placeholder] = n;
       self->placeholder = (self->placeholder + 1) % self->length;
-    };
+    });
   }
 };
 
@@ -165,7 +165,7 @@ struct SampleFilter {
   SampleFilter(uint64_t rate, cown_ptr<Delay> delay): rate(rate), delay(move(delay)), samples_received(0) {}
 
   static void value(const cown_ptr<SampleFilter>& self, uint64_t n) {
-    when(self) << [n](acquired_cown<SampleFilter> self)  mutable {
+    when(self) << stamped([n](acquired_cown<SampleFilter> self)  mutable {
       if (self->samples_received == 0) {
         Delay::value(self->delay, n);
       } else {
@@ -173,7 +173,7 @@ struct SampleFilter {
       }
 
       self->samples_received = (self->samples_received + 1) % self->rate;
-    };
+    });
   }
 };
 
@@ -184,9 +184,9 @@ struct TaggedForward {
   TaggedForward(uint64_t id, cown_ptr<Integrator> integrator): id(id), integrator(move(integrator)) {}
 
   static void value(const cown_ptr<TaggedForward>& self, uint64_t n) {
-    when(self) << [n](acquired_cown<TaggedForward> self)  mutable {
+    when(self) << stamped([n](acquired_cown<TaggedForward> self)  mutable {
       Integrator::value(self->integrator, self->id, n);
-    };
+    });
   }
 };
 
@@ -202,9 +202,9 @@ struct Bank {
                       make_cown<TaggedForward>(id, move(integrator)))))))) {}
 
   static void value(const cown_ptr<Bank>& self, uint64_t n) {
-    when(self) << [n](acquired_cown<Bank> self)  mutable {
+    when(self) << stamped([n](acquired_cown<Bank> self)  mutable {
       Delay::value(self->entry, n);
-    };
+    });
   }
 };
 
@@ -228,24 +228,24 @@ struct Branch {
   }
 
   static void value(const cown_ptr<Branch>& self, uint64_t n) {
-    when(self) << [n](acquired_cown<Branch> self)  mutable {
+    when(self) << stamped([n](acquired_cown<Branch> self)  mutable {
       for (const cown_ptr<Bank>& bank: self->banks) {
         Bank::value(bank, n);
       }
-    };
+    });
   }
 };
 
 void Source::boot(const cown_ptr<Source>& self) {
-  when(self) << [tag = self](acquired_cown<Source> self)  mutable {
+  when(self) << stamped([tag = self](acquired_cown<Source> self)  mutable {
     Branch::value(self->branch, self->current);
     self->current = (self->current + 1) % self->max;
     Producer::next(self->producer, move(tag));
-  };
+  });
 }
 
 void FirFilter::value(const cown_ptr<FirFilter>& self, uint64_t n) {
-  when(self) << [n](acquired_cown<FirFilter> self)  mutable {
+  when(self) << stamped([n](acquired_cown<FirFilter> self)  mutable {
     self->data[self->index] = n;
     self->index++;
 
@@ -269,7 +269,7 @@ void FirFilter::value(const cown_ptr<FirFilter>& self, uint64_t n) {
         SampleFilter::value(self->sample, sum);
       }
     }
-  };
+  });
 }
 };
 
@@ -279,30 +279,34 @@ struct FilterBank: public ActorBenchmark {
   const uint64_t sinkrate;
   const uint64_t width;
   uint64_t channels;
+  std::vector<std::vector<uint64_t>> h;
+  std::vector<std::vector<uint64_t>> f;
 
   FilterBank(uint64_t columns, uint64_t simulations, uint64_t channels, uint64_t sinkrate):
     simulations(simulations), columns(columns), sinkrate(sinkrate), width(columns), channels(std::max((uint64_t)2, std::min((uint64_t)33, channels))) {}
 
-  void run() {
-    using namespace filterbank;
-
-    vector<vector<uint64_t>> h(channels);
-    vector<vector<uint64_t>> f(channels);
+  void setup() {
+    h = std::vector<std::vector<uint64_t>>(channels);
+    f = std::vector<std::vector<uint64_t>>(channels);
 
     for (uint64_t i = 0; i < channels; ++i) {
-      h[i] = vector<uint64_t>(width);
-      f[i] = vector<uint64_t>(width);
+      h[i] = std::vector<uint64_t>(width);
+      f[i] = std::vector<uint64_t>(width);
       for (uint64_t j = 0; j < width; ++j) {
         h[i][j] = (j * columns) + (j * channels) + i + j + i + 1;
         f[i][j] = (i * j) + (i * i) + i + j;
       }
     }
+  }
+
+  void run() {
+    using namespace filterbank;
 
     auto producer = make_cown<Producer>(simulations);
     auto sink = make_cown<Sink>(sinkrate);
     auto combine = make_cown<Combine>(move(sink));
     auto integrator = make_cown<Integrator>(channels, move(combine));
-    auto branch = make_cown<Branch>(channels, columns, h, f, move(integrator));
+    auto branch = make_cown<Branch>(channels, columns, move(h), move(f), move(integrator));
     auto source = make_cown<Source>(producer, move(branch));
 
     Producer::next(producer, move(source));
@@ -311,4 +315,6 @@ struct FilterBank: public ActorBenchmark {
   inline static const std::string name = "Filterbank";
 };
 
+static const bool filterbank_registered = register_benchmark<FilterBank>(param<uint64_t>("columns", 16384), param<uint64_t>("simulations", 34816), param<uint64_t>("channels", 8), param<uint64_t>("sinkrate", 100));
+
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <cpp/when.h>
 #include <util/bench.h>
 #include <util/random.h>
+#include <algorithm>
 #include <cmath>
 #include <unordered_map>
 
@@ -23,9 +24,11 @@ struct Sorter {
   uint64_t length;
   uint64_t fragments;
   unique_ptr<vector<uint64_t>> results; // or None?
+  // Only set on the initial sorter.
+  validation::Result<vector<uint64_t>>::Completion done;
 
-  Sorter(Position position, uint64_t threshold, uint64_t length):
-    position(position), threshold(threshold), length(length), fragments(0), results(nullptr) {}
+  Sorter(Position position, uint64_t threshold, uint64_t length, validation::Result<vector<uint64_t>>::Completion done):
+    position(position), threshold(threshold), length(length), fragments(0), results(nullptr), done(done) {}
 
   Sorter(cown_ptr<Sorter> parent, Position position, uint64_t threshold, uint64_t length):
     parent(move(parent)), position(position), threshold(threshold), length(length), fragments(0), results(nullptr) {}
@@ -72,15 +75,14 @@ struct Sorter {
 
   void notify_parent() {
     if (position == Position::Initial) {
-      // assert(is_sorted(results->begin(), results->end()));
-      /* done */
+      done(move(*results));
     } else {
       Sorter::result(parent, move(results), position);
     }
   }
 
   static void sort(const cown_ptr<Sorter>& self, unique_ptr<vector<uint64_t>> input) {
-    when(self) << [tag=self, input=move(input)](acquired_cown<Sorter> self) mutable {
+    when(self) << stamped([tag=self, input=move(input)](acquired_cown<Sorter> self) mutable {
       uint64_t size = input->size();
 
       if (size < self->threshold){
@@ -100,11 +102,11 @@ struct Sorter {
         self->results = move(p);
         self->fragments++;
       }
-    };
+    });
   }
 
   static void result(const cown_ptr<Sorter>& self, unique_ptr<vector<uint64_t>> sorted, Position position) {
-    when(self) << [tag=self, sorted=move(sorted), position](acquired_cown<Sorter> self) mutable {
+    when(self) << stamped([tag=self, sorted=move(sorted), position](acquired_cown<Sorter> self) mutable {
       if (sorted->size() > 0) {
         unique_ptr<vector<uint64_t>> temp = make_unique<vector<uint64_t>>();
 
@@ -125,7 +127,7 @@ struct Sorter {
 
       if (self->fragments == 3)
         self->notify_parent();
-    };
+    });
   }
 };
 
@@ -136,31 +138,55 @@ struct Quicksort: public ActorBenchmark {
   uint64_t max;
   uint64_t threshold;
   uint64_t seed;
+  std::unique_ptr<std::vector<uint64_t>> data;
+  validation::Result<std::vector<uint64_t>> sorted;
+  // The input sorted sequentially, computed on the first --validate.
+  std::vector<uint64_t> expected;
 
   Quicksort(uint64_t dataset, uint64_t max, uint64_t threshold, uint64_t seed):
     dataset(dataset), max(max), threshold(threshold), seed(seed) {}
 
-
-  void run() {
-    using namespace std;
-
-    unique_ptr<vector<uint64_t>> data = make_unique<vector<uint64_t>>();
+  std::vector<uint64_t> generate() {
     SimpleRand random(seed);
+    std::vector<uint64_t> input;
 
     for (uint64_t i = 0; i < dataset; ++i) {
-      data->push_back(random.nextLong() % max);
+      input.push_back(random.nextLong() % max);
     }
 
+    return input;
+  }
+
+  void setup() {
+    data = std::make_unique<std::vector<uint64_t>>(generate());
+  }
+
+  void run() {
+    using namespace std;
+
     // cout << "unsorted: ";
     // for(const auto& e: data)
     //   cout << e << ", ";
     // cout << endl;
 
     using namespace quicksort;
-    Sorter::sort(make_cown<Sorter>(Position::Initial, threshold, dataset), move(data));
+    Sorter::sort(make_cown<Sorter>(Position::Initial, threshold, dataset, sorted.completion()), move(data));
+  }
+
+  bool validates() { return true; }
+
+  std::string validate() {
+    if (expected.size() != dataset) {
+      expected = generate();
+      std::sort(expected.begin(), expected.end());
+    }
+
+    return validation::expect_elements("sorted", sorted.value, expected);
   }
 
   inline static const std::string name = "Quicksort";
 };
 
+static const bool quicksort_registered = register_benchmark<Quicksort>(param<uint64_t>("dataset", 1000000), param<uint64_t>("max", uint64_t(1) << 60), param<uint64_t>("threshold", 2048), param<uint64_t>("seed", 1024));
+
 };
\ No newline at end of file
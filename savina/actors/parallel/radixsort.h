@@ -25,26 +25,29 @@ struct Validation {
   uint64_t received;
   uint64_t previous;
   tuple<int64_t, int32_t> error;
+  // Only kept with --validate.
+  vector<uint64_t> data;
+  validation::Result<vector<uint64_t>>::Completion done;
 
-  Validation(uint64_t size): size(size), sum(0), received(0), previous(0), error(make_tuple(-1, -1)) {}
+  Validation(uint64_t size, validation::Result<vector<uint64_t>>::Completion done): size(size), sum(0), received(0), previous(0), error(make_tuple(-1, -1)), done(done) {}
 
   static void value(const cown_ptr<Validation>& self, uint64_t n) {
-    when(self) << [n](acquired_cown<Validation> self)  mutable {
+    when(self) << stamped([n](acquired_cown<Validation> self)  mutable {
       self->received++;
       if (n < self->previous && get<1>(self->error) < 0) {
         self->error = make_tuple(n, self->received - 1);
       }
 
-      // self->data.push_back(n);
+      if (validation::enabled)
+        self->data.push_back(n);
 
       self->previous = n;
       self->sum += self->previous;
 
       if (self->received == self->size) {
-        // cout << "sorted: " << (is_sorted(self->data.begin(), self->data.end()) ? "true": "false") << endl;
-        /* done */
+        self->done(move(self->data));
       }
-    };
+    });
   }
 };
 
@@ -66,7 +69,7 @@ struct Sorter {
   // The pipeline seems intrinsic to the order
 
   static void value(const cown_ptr<Sorter>& self, uint64_t n) {
-    when(self) << [n](acquired_cown<Sorter> self) mutable {
+    when(self) << stamped([n](acquired_cown<Sorter> self) mutable {
       self->received++;
 
       if ((n & self->radix) == 0) {
@@ -86,7 +89,7 @@ struct Sorter {
           for(uint64_t i = 0 ; i < self->current; ++i)
             Validation::value(self->validation, self->data[i]);
       }
-    };
+    });
   }
 };
 
@@ -112,6 +115,9 @@ struct Radixsort: public ActorBenchmark {
   uint64_t dataset;
   uint64_t max;
   uint64_t seed;
+  validation::Result<std::vector<uint64_t>> sorted;
+  // The input sorted sequentially, computed on the first --validate.
+  std::vector<uint64_t> expected;
 
   Radixsort(uint64_t dataset, uint64_t max, uint64_t seed):
     dataset(dataset), max(max), seed(seed) {}
@@ -119,8 +125,10 @@ struct Radixsort: public ActorBenchmark {
   void run() {
     using namespace radixsort;
 
-    uint64_t radix = max / 2;
-    cown_ptr<Validation> v = make_cown<Validation>(dataset);
+    // Each sorter partitions on a single bit, starting from the highest bit a
+    // value below max can have. This is max / 2 when max is a power of two.
+    uint64_t radix = (max > 1) ? (uint64_t(1) << (63 - __builtin_clzll(max - 1))) : 0;
+    cown_ptr<Validation> v = make_cown<Validation>(dataset, sorted.completion());
 
     if (radix > 0) {
       cown_ptr<Sorter> next = make_cown<Sorter>(dataset, radix, move(v));
@@ -136,7 +144,23 @@ struct Radixsort: public ActorBenchmark {
     }
   }
 
+  bool validates() { return true; }
+
+  std::string validate() {
+    if (expected.size() != dataset) {
+      SimpleRand random(seed);
+      expected.clear();
+      for (uint64_t i = 0; i < dataset; ++i)
+        expected.push_back(random.nextLong() % max);
+      std::sort(expected.begin(), expected.end());
+    }
+
+    return validation::expect_elements("sorted", sorted.value, expected);
+  }
+
   inline static const std::string name = "Radixsort";
 };
 
+static const bool radixsort_registered = register_benchmark<Radixsort>(param<uint64_t>("dataset", 100000), param<uint64_t>("max", uint64_t(1) << 60), param<uint64_t>("seed", 2048));
+
 };
\ No newline at end of file
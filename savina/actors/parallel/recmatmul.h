@@ -26,10 +26,11 @@ struct Master {
   uint64_t sent;
   uint64_t completed;
   uint64_t num_workers;
+  validation::Result<vector<vector<uint64_t>>>::Completion finished;
 
   Master() {}
 
-  static void make(uint64_t workers, uint64_t data_length, uint64_t threshold);
+  static void make(uint64_t workers, uint64_t data_length, uint64_t threshold, vector<vector<uint64_t>> a, vector<vector<uint64_t>> b, validation::Result<vector<vector<uint64_t>>>::Completion finished);
   void send_work(uint64_t priority, uint64_t srA, uint64_t scA, uint64_t srB, uint64_t scB, uint64_t srC, uint64_t scC, uint64_t length, uint64_t dimension);
   static void work(const cown_ptr<Master>& self, uint64_t priority, uint64_t srA, uint64_t scA, uint64_t srB, uint64_t scB, uint64_t srC, uint64_t scC, uint64_t length, uint64_t dimension);
   static void done(const cown_ptr<Master>&);
@@ -45,16 +46,16 @@ struct Collector {
   }
 
   static void collect(const cown_ptr<Collector>& self, vector<tuple<uint64_t, uint64_t, uint64_t>> partial_result) {
-    when(self) << [partial_result=move(partial_result)](acquired_cown<Collector> self)  mutable{
+    when(self) << stamped([partial_result=move(partial_result)](acquired_cown<Collector> self)  mutable{
       for (uint64_t n = 0; n < partial_result.size(); ++n) {
         auto coord = partial_result[n];
         auto i = get<0>(coord);
         auto j = get<1>(coord);
         auto r = get<2>(coord);
 
-        self->result[i][j] = r;
+        self->result[i][j] += r;
       }
-    };
+    });
   }
 
 };
@@ -73,9 +74,10 @@ struct Worker {
   static void work(const cown_ptr<Worker>& self, uint64_t priority, uint64_t srA, uint64_t scA, uint64_t srB, uint64_t scB, uint64_t srC, uint64_t scC, uint64_t length, uint64_t dimension);
 };
 
-void Master::make(uint64_t workers, uint64_t data_length, uint64_t threshold) {
+void Master::make(uint64_t workers, uint64_t data_length, uint64_t threshold, vector<vector<uint64_t>> a, vector<vector<uint64_t>> b, validation::Result<vector<vector<uint64_t>>>::Completion finished) {
   cown_ptr<Master> master = make_cown<Master>();
-  when(master) << [workers, data_length, threshold, tag=move(master)](acquired_cown<Master> master)  mutable{
+  when(master) << stamped([workers, data_length, threshold, a=move(a), b=move(b), finished, tag=move(master)](acquired_cown<Master> master)  mutable{
+    master->finished = finished;
     master->length = data_length;
     master->num_blocks = data_length * data_length;
     master->sent = 0;
@@ -83,22 +85,6 @@ void Master::make(uint64_t workers, uint64_t data_length, uint64_t threshold) {
     master->num_workers = workers;
     master->collector = make_cown<Collector>(data_length);
 
-    vector<vector<uint64_t>> a;
-    vector<vector<uint64_t>> b;
-
-    for (uint64_t i = 0; i < data_length; ++i) {
-      vector<uint64_t> aI;
-      vector<uint64_t> bI;
-
-      for (uint64_t j = 0; j < data_length; ++j) {
-        aI.push_back(i);
-        bI.push_back(j);
-      }
-
-      a.push_back(aI);
-      b.push_back(bI);
-    }
-
     for (uint64_t k = 0; k < workers; ++k) {
       master->workers.emplace_back(make_cown<Worker>(tag, master->collector, a, b, threshold));
     }
@@ -107,7 +93,7 @@ void Master::make(uint64_t workers, uint64_t data_length, uint64_t threshold) {
     master->matrix_b = move(b);
 
     master->send_work(0, 0, 0, 0, 0, 0, 0, master->num_blocks, data_length);
-  };
+  });
 }
 
 void Master::send_work(uint64_t priority, uint64_t srA, uint64_t scA, uint64_t srB, uint64_t scB, uint64_t srC, uint64_t scC, uint64_t length, uint64_t dimension) {
@@ -117,23 +103,24 @@ void Master::send_work(uint64_t priority, uint64_t srA, uint64_t scA, uint64_t s
 }
 
 void Master::work(const cown_ptr<Master>& self, uint64_t priority, uint64_t srA, uint64_t scA, uint64_t srB, uint64_t scB, uint64_t srC, uint64_t scC, uint64_t length, uint64_t dimension) {
-  when(self) << [=](acquired_cown<Master> self)  mutable{
+  when(self) << stamped([=](acquired_cown<Master> self)  mutable{
     self->send_work(priority, srA, scA, srB, scB, srC, scC, length, dimension);
-  };
+  });
 }
 
 void Master::done(const cown_ptr<Master>& self) {
-  when(self) << [](acquired_cown<Master> self)  mutable{
+  when(self) << stamped([](acquired_cown<Master> self)  mutable{
     if (++self->completed == self->sent) {
       self->workers.clear();
+      if (validation::wanted())
+        when(self->collector) << stamped([finished=self->finished](acquired_cown<Collector> collector) { finished(move(collector->result)); });
       self->collector = nullptr;
-      /* done */
     }
-  };
+  });
 }
 
 void Worker::work(const cown_ptr<Worker>& self, uint64_t priority, uint64_t srA, uint64_t scA, uint64_t srB, uint64_t scB, uint64_t srC, uint64_t scC, uint64_t length, uint64_t dimension) {
-  when(self) << [=] (acquired_cown<Worker> self) mutable {
+  when(self) << stamped([=] (acquired_cown<Worker> self) mutable {
     if (length > self->threshold) {
       auto new_priority = priority + 1;
       auto new_dimension = dimension / 2;
@@ -176,7 +163,7 @@ void Worker::work(const cown_ptr<Worker>& self, uint64_t priority, uint64_t srA,
       Collector::collect(self->collector, move(partial_result));
     }
     Master::done(self->master);
-  };
+  });
 }
 
 };
@@ -185,15 +172,60 @@ struct Recmatmul: public ActorBenchmark {
   uint64_t workers;
   uint64_t length;
   uint64_t threshold;
+  std::vector<std::vector<uint64_t>> a;
+  std::vector<std::vector<uint64_t>> b;
+  validation::Result<std::vector<std::vector<uint64_t>>> product;
 
   Recmatmul(uint64_t workers, uint64_t length, uint64_t threshold, uint64_t priorities):
     workers(workers), length(length), threshold(threshold) {}
 
+  void setup() {
+    a.clear();
+    b.clear();
+
+    for (uint64_t i = 0; i < length; ++i) {
+      std::vector<uint64_t> aI;
+      std::vector<uint64_t> bI;
+
+      for (uint64_t j = 0; j < length; ++j) {
+        aI.push_back(i);
+        bI.push_back(j);
+      }
+
+      a.push_back(aI);
+      b.push_back(bI);
+    }
+  }
+
   void run() {
-    recmatmul::Master::make(workers, length, threshold);
+    recmatmul::Master::make(workers, length, threshold, std::move(a), std::move(b), product.completion());
+  }
+
+  bool validates() { return true; }
+
+  // Row i of a is all i and column j of b is all j, so the product is
+  // length * i * j.
+  std::string validate() {
+    if (!product.value)
+      return "product was never produced";
+
+    if (product.value->size() != length)
+      return validation::expect("rows", std::optional<uint64_t>(product.value->size()), length);
+
+    for (uint64_t i = 0; i < length; ++i) {
+      for (uint64_t j = 0; j < length; ++j) {
+        uint64_t expected = length * i * j;
+        if ((*product.value)[i][j] != expected)
+          return validation::expect("product[" + std::to_string(i) + "][" + std::to_string(j) + "]", std::optional<uint64_t>((*product.value)[i][j]), expected);
+      }
+    }
+
+    return "";
   }
 
   inline static const std::string name = "Recursive Matrix Multiplication";
 };
 
+static const bool recmatmul_registered = register_benchmark<Recmatmul>(param<uint64_t>("workers", 20), param<uint64_t>("length", 1024), param<uint64_t>("threshold", 16384), param<uint64_t>("priorities", 10));
+
 };
@@ -54,26 +54,29 @@ struct PrimeFilter {
   }
 
   static void check_value(const cown_ptr<PrimeFilter>& self, uint64_t value) {
-    when(self) << [value](acquired_cown<PrimeFilter> self)  mutable{
+    when(self) << stamped([value](acquired_cown<PrimeFilter> self)  mutable{
       if (self->is_local(value)) {
         if (self->next)
           PrimeFilter::check_value(self->next, value);
         else
           self->handle_prime(value);
       }
-    };
+    });
   }
 
-  static void done(const cown_ptr<PrimeFilter>& self) {
-    when(self) << [](acquired_cown<PrimeFilter> self)  mutable{
+  // Counts the primes found as it passes down the pipeline.
+  static void done(const cown_ptr<PrimeFilter>& self, uint64_t primes, validation::Result<uint64_t>::Completion result) {
+    when(self) << stamped([primes, result](acquired_cown<PrimeFilter> self)  mutable{
       if (self->next)
-        PrimeFilter::done(self->next);
-    };
+        PrimeFilter::done(self->next, primes + self->available, result);
+      else
+        result(primes + self->available);
+    });
   }
 };
 
 namespace NumberProducer {
-  void create(uint64_t size, const cown_ptr<PrimeFilter>& filter) {
+  void create(uint64_t size, const cown_ptr<PrimeFilter>& filter, validation::Result<uint64_t>::Completion result) {
     uint64_t candidate = 3;
 
     while (candidate < size) {
@@ -81,7 +84,7 @@ namespace NumberProducer {
       candidate += 2;
     }
 
-    PrimeFilter::done(filter);
+    PrimeFilter::done(filter, 0, result);
   }
 };
 
@@ -90,15 +93,35 @@ namespace NumberProducer {
 struct Sieve: public ActorBenchmark {
   uint64_t size;
   uint64_t buffersize;
+  validation::Result<uint64_t> primes;
 
   Sieve(uint64_t size, uint64_t buffersize): size(size), buffersize(buffersize) {}
 
   void run() {
     using namespace sieve;
-    NumberProducer::create(size, make_cown<PrimeFilter>(buffersize));
+    NumberProducer::create(size, make_cown<PrimeFilter>(buffersize), primes.completion());
+  }
+
+  bool validates() { return true; }
+
+  // The producer offers 2 and the odd numbers below size.
+  std::string validate() {
+    std::vector<bool> composite(std::max<uint64_t>(size, 3), false);
+    uint64_t expected = 1;
+    for (uint64_t i = 3; i < size; i += 2) {
+      if (composite[i])
+        continue;
+      expected++;
+      for (uint64_t m = i * i; m < size; m += 2 * i)
+        composite[m] = true;
+    }
+
+    return validation::expect("primes", primes.value, expected);
   }
 
   inline static const std::string name = "Sieve of Eratosthenes";
 };
 
+static const bool sieve_registered = register_benchmark<Sieve>(param<uint64_t>("size", 100000), param<uint64_t>("buffersize", 1000));
+
 };
\ No newline at end of file
@@ -13,33 +13,37 @@ struct Master;
 
 struct Worker {
   static void create(cown_ptr<Master> master, double left, double right, double precision);
+  static double integrate(double left, double right, double precision);
 };
 
 struct Master {
   double result_area;
   uint64_t workers;
+  validation::Result<double>::Completion done;
 
-  static cown_ptr<Master> create(uint64_t workers, double left, double right, double precision) {
-    auto master = make_cown<Master>();
-    when(master) << [tag=master, workers, left, right, precision](acquired_cown<Master> master) mutable {
+  Master(uint64_t workers, validation::Result<double>::Completion done): result_area(0), workers(workers), done(done) {}
+
+  static cown_ptr<Master> create(uint64_t workers, double left, double right, double precision, validation::Result<double>::Completion done) {
+    auto master = make_cown<Master>(workers, done);
+    when(master) << stamped([tag=master, workers, left, right, precision](acquired_cown<Master> master) mutable {
       auto range = (right-left)/workers;
 
       for (uint64_t i = 0; i < workers; ++i) {
-        left += (range * i);
-        Worker::create(tag, left, left + range, precision);
+        double start = left + (range * i);
+        Worker::create(tag, start, start + range, precision);
       }
-    };
+    });
     return master;
   }
 
   static void result(const cown_ptr<Master>& self, double area) {
-    when(self) << [area](acquired_cown<Master> self) mutable {
+    when(self) << stamped([area](acquired_cown<Master> self) mutable {
       self->result_area += area;
 
       if (--self->workers == 0) {
-        /* done */
+        self->done(self->result_area);
       }
-    };
+    });
   }
 };
 
@@ -54,27 +58,34 @@ namespace Fx {
   }
 }
 
-void Worker::create(cown_ptr<Master> master, double left, double right, double precision) {
-  auto worker = make_cown<Worker>();
-  when(worker) << [master=move(master), left, right, precision](acquired_cown<Worker> worker) mutable {
-    double n = ((right - left) / precision);
-    double accumulated_area = 0.0;
+double Worker::integrate(double left, double right, double precision) {
+  // A whole number of pieces, so that each worker covers its share of the
+  // range exactly rather than integrating a piece beyond it.
+  double n = std::max(1.0, std::round((right - left) / precision));
+  precision = (right - left) / n;
+  double accumulated_area = 0.0;
 
-    double i = 0.0;
-    while (i < n) {
-      auto lx = (i * precision) + left;
-      auto rx = lx + precision;
+  double i = 0.0;
+  while (i < n) {
+    auto lx = (i * precision) + left;
+    auto rx = lx + precision;
 
-      auto ly = Fx::apply(lx);
-      auto ry = Fx::apply(rx);
+    auto ly = Fx::apply(lx);
+    auto ry = Fx::apply(rx);
 
-      accumulated_area += (0.5 * (ly + ry) * precision);
+    accumulated_area += (0.5 * (ly + ry) * precision);
 
-      i++;
-    }
+    i++;
+  }
 
-    Master::result(master, accumulated_area);
-  };
+  return accumulated_area;
+}
+
+void Worker::create(cown_ptr<Master> master, double left, double right, double precision) {
+  auto worker = make_cown<Worker>();
+  when(worker) << stamped([master=move(master), left, right, precision](acquired_cown<Worker> worker) mutable {
+    Master::result(master, integrate(left, right, precision));
+  });
 }
 
 };
@@ -85,13 +96,36 @@ struct Trapezoid: public ActorBenchmark {
   uint64_t left;
   uint64_t right;
   double precision;
+  validation::Result<double> area;
+  // The integral by Simpson's rule and how far the trapezoid rule may be from
+  // it, computed on the first --validate.
+  std::optional<double> expected;
+  double tolerance = 0;
 
   Trapezoid(uint64_t pieces, uint64_t workers, uint64_t left, uint64_t right):
     pieces(pieces), workers(workers), left(left), right(right), precision(double(right - left) / (double)pieces) {}
 
-  void run() { trapezoid::Master::create(workers, left, right, precision); }
+  void run() { trapezoid::Master::create(workers, left, right, precision, area.completion()); }
+
+  bool validates() { return true; }
+
+  std::string validate() {
+    // Savina's integrand, written out again rather than taken from the
+    // workers so that a mistake in theirs is caught. The trapezoid rule is
+    // off by about h^2 / 12 (f'(right) - f'(left)), so twice that is allowed.
+    if (!expected) {
+      auto f = [](double x) { return std::sin(x * x * x - 1) / (x + 1) * std::sqrt(1 + std::exp(std::sqrt(2 * x))); };
+      auto slope = [&](double x) { return (f(x + 1e-5) - f(x - 1e-5)) / 2e-5; };
+      expected = validation::simpson(f, left, right, uint64_t(1) << 21);
+      tolerance = 1e-9 + 2 * std::abs(precision * precision / 12 * (slope(right) - slope(left)));
+    }
+
+    return validation::expect_near("area", area.value, *expected, tolerance);
+  }
 
   inline static const std::string name = "Trapezoid";
 };
 
+static const bool trapezoid_registered = register_benchmark<Trapezoid>(param<uint64_t>("pieces", 10000000), param<uint64_t>("workers", 100), param<uint64_t>("left", 1), param<uint64_t>("right", 5));
+
 };
\ No newline at end of file
@@ -1,9 +1,12 @@
+// Benchmarks register themselves in include order, which is the order the
+// suite runs and reports them in. It is kept as it was before the registry,
+// with later additions at the end, so that results line up with older runs.
 #include "concurrency/banking.h"
 #include "concurrency/barber.h"
 #include "concurrency/bndbuffer.h"
 #include "concurrency/concdict.h"
-#include "concurrency/logmap.h"
 #include "concurrency/philosopher.h"
+#include "concurrency/logmap.h"
 
 #include "micro/chameneos.h"
 #include "micro/count.h"
@@ -13,4 +16,6 @@
 
 #include "parallel/quicksort.h"
 #include "parallel/trapezoid.h"
+
+#include "micro/startup.h"
 #include "parallel/sieve.h"
\ No newline at end of file
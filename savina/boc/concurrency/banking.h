@@ -32,9 +32,10 @@ struct Teller {
   uint64_t completed;
   std::vector<cown_ptr<Account>> accounts;
   bool busy_wait;
+  validation::Result<uint64_t>::Completion done;
 
-  Teller(double initial_balance, uint64_t num_accounts, uint64_t transactions, bool busy_wait):
-    initial_balance(initial_balance), transactions(transactions), random(SimpleRand(123456)), completed(0), busy_wait(busy_wait) {
+  Teller(double initial_balance, uint64_t num_accounts, uint64_t transactions, bool busy_wait, validation::Result<uint64_t>::Completion done):
+    initial_balance(initial_balance), transactions(transactions), random(SimpleRand(123456)), completed(0), busy_wait(busy_wait), done(done) {
 
     for (uint64_t i = 0; i < num_accounts; i++)
     {
@@ -43,45 +44,54 @@ struct Teller {
   }
 
   static void spawn_transactions(const cown_ptr<Teller>& self) {
-    when(self) << [tag=self](acquired_cown<Teller> self)  mutable {
+    when(self) << stamped([tag=self](acquired_cown<Teller> self)  mutable {
       for (uint64_t i = 0; i < self->transactions; i++)
       {
-        // Randomly pick source and destination account
-        uint64_t source;
-        uint64_t dest;
-
-        do { // changed from actors to avoid deadlock from aliasing
-          source = self->random.nextInt((self->accounts.size() / 10) * 8);
-          dest = self->random.nextInt(self->accounts.size() - source);
-        } while(source == dest);
-
-        if (dest == 0)
-          dest++;
-
-        const cown_ptr<Account>& src = self->accounts[source];
-        const cown_ptr<Account>& dst = self->accounts[dest];
-        double amount = self->random.nextDouble() * 1000;
-
-        when(src, dst) << [busy_wait = self->busy_wait, amount, tag](acquired_cown<Account> src, acquired_cown<Account> dst) mutable {
-          src->debit(amount);
-          dst->credit(amount);
-          if (busy_wait) {
-            busy_loop(10);
-          }
-          Teller::reply(tag);
-        };
+        self->transfer(tag);
+      }
+    });
+  }
+
+  void transfer(const cown_ptr<Teller>& tag) {
+    // Randomly pick source and destination account
+    uint64_t source;
+    uint64_t dest;
+
+    do { // changed from actors to avoid deadlock from aliasing
+      source = random.nextInt((accounts.size() / 10) * 8);
+      dest = random.nextInt(accounts.size() - source);
+    } while(source == dest);
 
+    if (dest == 0)
+      dest++;
+
+    const cown_ptr<Account>& src = accounts[source];
+    const cown_ptr<Account>& dst = accounts[dest];
+    double amount = random.nextDouble() * 1000;
+
+    when(src, dst) << stamped([busy_wait = busy_wait, amount, tag](acquired_cown<Account> src, acquired_cown<Account> dst) mutable {
+      src->debit(amount);
+      dst->credit(amount);
+      if (busy_wait) {
+        busy_loop(10);
       }
-    };
+      Teller::reply(tag);
+    });
   }
 
   static void reply(const cown_ptr<Teller>& self) {
-    when(self) << [](acquired_cown<Teller> self)  mutable {
+    when(self) << stamped([](acquired_cown<Teller> self)  mutable {
       self->completed++;
-      if (self->completed == self->transactions) {
+      Throughput::completed();
+      // With --duration, keep the same number of transactions in flight.
+      if (Throughput::more(false)) {
+        self->transfer(self.cown());
         return;
       }
-    };
+      if (self->completed == self->transactions) {
+        self->done(self->completed);
+      }
+    });
   }
 };
 
@@ -92,6 +102,7 @@ struct Banking: public BocBenchmark {
   uint64_t transactions;
   double initial;
   bool busy_wait;
+  validation::Result<uint64_t> completed;
 
   Banking(uint64_t accounts, uint64_t transactions, bool busy_wait = false): accounts(accounts), transactions(transactions), busy_wait(busy_wait) {
     initial = DBL_MAX / float(accounts * transactions);
@@ -99,11 +110,19 @@ struct Banking: public BocBenchmark {
 
   void run() {
     using namespace banking;
-    Teller::spawn_transactions(make_cown<Teller>(initial, accounts, transactions, busy_wait));
+    Teller::spawn_transactions(make_cown<Teller>(initial, accounts, transactions, busy_wait, completed.completion()));
   }
 
+  bool continuous() { return true; }
+
+  bool validates() { return true; }
+
+  std::string validate() { return validation::expect("completed transactions", completed.value, transactions); }
+
   inline static const std::string name = "Banking";
 };
 
+static const bool banking_registered = register_benchmark<Banking>(param<uint64_t>("accounts", 1000), param<uint64_t>("transactions", 50000), param<bool>("busy_wait", false));
+
 
 };
\ No newline at end of file
@@ -185,60 +185,60 @@ struct WaitingRoom {
   WaitingRoom(uint64_t size, const cown_ptr<Barber>& barber): size(size), barber(barber) {}
 
   static void enter(const cown_ptr<WaitingRoom>& wr, cown_ptr<Customer> customer) {
-    when(wr) << [customer=move(customer)](acquired_cown<WaitingRoom> wr) {
+    when(wr) << stamped([customer=move(customer)](acquired_cown<WaitingRoom> wr) {
       if (wr->count == wr->size) {
         Customer::full(move(customer));
       } else {
         wr->count++;
 
-        when(wr->barber, customer) << [wr=wr.cown()](acquired_cown<Barber> barber, acquired_cown<Customer> customer) {
-          when(wr) << [](acquired_cown<WaitingRoom> wr) { wr->count--; };
+        when(wr->barber, customer) << stamped([wr=wr.cown()](acquired_cown<Barber> barber, acquired_cown<Customer> customer) {
+          when(wr) << stamped([](acquired_cown<WaitingRoom> wr) { wr->count--; });
 
           // barber->sleeping = false;
           customer->sit_down();
           BusyWaiter(Rand(time_point_cast<nanoseconds>(system_clock::now()).time_since_epoch().count()).integer(barber->haircut_rate) + 10, barber->random);
           CustomerFactory::left(customer->factory, customer.cown());
 
-          when(barber.cown(), wr) << [](acquired_cown<Barber> barber, acquired_cown<WaitingRoom> wr) {
+          when(barber.cown(), wr) << stamped([](acquired_cown<Barber> barber, acquired_cown<WaitingRoom> wr) {
             // barber->sleeping = wr->count == 0;
-          };
-        };
+          });
+        });
       }
-    };
+    });
   }
 };
 
-void Barber::wait(const cown_ptr<Barber>& self) { when(self) << [](acquired_cown<Barber>){}; }
+void Barber::wait(const cown_ptr<Barber>& self) { when(self) << stamped([](acquired_cown<Barber>){}); }
 
 void CustomerFactory::returned(const cown_ptr<CustomerFactory>& self, cown_ptr<Customer> customer) {
-  when(self) << [customer=move(customer)](acquired_cown<CustomerFactory> self) {
+  when(self) << stamped([customer=move(customer)](acquired_cown<CustomerFactory> self) {
     self->attempts++;
     WaitingRoom::enter(self->room, move(customer));
-  };
+  });
 }
 
 // TODO: in verona we don't need to send a message back to the framework
 void CustomerFactory::left(const cown_ptr<CustomerFactory>& self, cown_ptr<Customer> customer) {
-  when(self) << [](acquired_cown<CustomerFactory> self) {
+  when(self) << stamped([](acquired_cown<CustomerFactory> self) {
     self->number_of_haircuts--;
     if (self->number_of_haircuts == 0) {
       // std::cout << "attempts: " << self->attempts << std::endl;
-      return;
+      CompletionLatch::signal();
     }
-  };
+  });
 }
 
 void CustomerFactory::run(cown_ptr<CustomerFactory>&& self, uint64_t rate) {
-  when(self) << [tag=self, rate](acquired_cown<CustomerFactory> self) {
+  when(self) << stamped([tag=self, rate](acquired_cown<CustomerFactory> self) {
     for (uint64_t i = 0; i < self->number_of_haircuts; ++i) {
       self->attempts++;
       WaitingRoom::enter(self->room, make_cown<Customer>(tag));
       BusyWaiter(Rand(time_point_cast<nanoseconds>(system_clock::now()).time_since_epoch().count()).integer(rate) + 10, self->random);
     }
-  };
+  });
 }
 
-void Customer::full(const cown_ptr<Customer>& self) { when(self) << [](acquired_cown<Customer> self){ CustomerFactory::returned(self->factory, self.cown()); }; }
+void Customer::full(const cown_ptr<Customer>& self) { when(self) << stamped([](acquired_cown<Customer> self){ CustomerFactory::returned(self->factory, self.cown()); }); }
 
 void Customer::wait() { }
 //#endif
@@ -261,4 +261,6 @@ struct SleepingBarber: public BocBenchmark {
   inline static const std::string name = "Sleeping Barber";
 };
 
+static const bool sleepingbarber_registered = register_benchmark<SleepingBarber>(param<uint64_t>("haircuts", 5000), param<uint64_t>("room", 1000), param<uint64_t>("production", 1000), param<uint64_t>("cut", 1000));
+
 };
\ No newline at end of file
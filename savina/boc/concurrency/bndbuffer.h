@@ -105,7 +105,7 @@ struct Consumer {
 cown_ptr<Manager> Manager::make_manager(uint64_t buffersize, uint64_t producers, uint64_t consumers, uint64_t items, uint64_t producercosts, uint64_t consumercosts) {
   cown_ptr<Manager> self = make_cown<Manager>(buffersize, producers, consumers);
 
-  when(self) << [tag=self, producers, consumers, items, producercosts, consumercosts](acquired_cown<Manager> self)  mutable {
+  when(self) << stamped([tag=self, producers, consumers, items, producercosts, consumercosts](acquired_cown<Manager> self)  mutable {
     for (uint64_t i = 0; i < producers; i++)
     {
       const cown_ptr<Producer>& producer = make_cown<Producer>(tag, items, producercosts);
@@ -117,7 +117,7 @@ cown_ptr<Manager> Manager::make_manager(uint64_t buffersize, uint64_t producers,
       const cown_ptr<Consumer>& consumer = make_cown<Consumer>(tag, consumercosts);
       self->availableConsumers.push_back(consumer);
     }
-  };
+  });
 
   return self;
 }
@@ -128,15 +128,15 @@ void Manager::complete() {
 }
 
 void Manager::rendezvous(const cown_ptr<Producer>& producer, const cown_ptr<Consumer>& consumer) {
-  when(consumer, producer) << [ctag=consumer, ptag=producer](acquired_cown<Consumer> consumer, acquired_cown<Producer> producer)  mutable {
+  when(consumer, producer) << stamped([ctag=consumer, ptag=producer](acquired_cown<Consumer> consumer, acquired_cown<Producer> producer)  mutable {
     consumer->consume(producer->produce());
     consumer->release(ctag);
     producer->release(ptag);
-  };
+  });
 }
 
 void Manager::data(const cown_ptr<Manager>& self, const cown_ptr<Producer>& producer) {
-  when(self) << [producer](acquired_cown<Manager> self)  mutable {
+  when(self) << stamped([producer](acquired_cown<Manager> self)  mutable {
     if (self->availableConsumers.empty()) {
       if (self->availableProducers.size() < self->adjusted)
         self->availableProducers.push_back(producer);
@@ -147,11 +147,11 @@ void Manager::data(const cown_ptr<Manager>& self, const cown_ptr<Producer>& prod
       self->availableConsumers.pop_front();
       Manager::rendezvous(producer, consumer);
     }
-  };
+  });
 }
 
 void Manager::available(const cown_ptr<Manager>& self, const cown_ptr<Consumer>& consumer) {
-  when(self) << [consumer](acquired_cown<Manager> self)  mutable {
+  when(self) << stamped([consumer](acquired_cown<Manager> self)  mutable {
     if (self->availableProducers.empty()) {
       self->availableConsumers.push_back(consumer);
       self->complete();
@@ -163,18 +163,18 @@ void Manager::available(const cown_ptr<Manager>& self, const cown_ptr<Consumer>&
       if (!self->pendingProducers.empty()) {
         cown_ptr<Producer> producer = self->pendingProducers.front();
         self->pendingProducers.pop_front();
-        when(producer) << [tag=producer](acquired_cown<Producer> producer) mutable { producer->release(tag); };
+        when(producer) << stamped([tag=producer](acquired_cown<Producer> producer) mutable { producer->release(tag); });
         // self->availableProducers.push_back(producer);
       }
     }
-  };
+  });
 }
 
 void Manager::exit(const cown_ptr<Manager>& self) {
-  when(self) << [](acquired_cown<Manager> self)  mutable {
+  when(self) << stamped([](acquired_cown<Manager> self)  mutable {
     self->producer_count--;
     self->complete();
-  };
+  });
 }
 
 #else
@@ -257,7 +257,7 @@ struct Consumer {
 cown_ptr<Manager> Manager::make_manager(uint64_t buffersize, uint64_t producers, uint64_t consumers, uint64_t items, uint64_t producercosts, uint64_t consumercosts) {
   cown_ptr<Manager> self = make_cown<Manager>(buffersize, producers, consumers);
 
-  when(self) << [tag=self, producers, consumers, items, producercosts, consumercosts](acquired_cown<Manager> self)  mutable {
+  when(self) << stamped([tag=self, producers, consumers, items, producercosts, consumercosts](acquired_cown<Manager> self)  mutable {
     for (uint64_t i = 0; i < producers; i++)
     {
       Manager::data(tag, make_unique<Producer>(tag, items, producercosts));
@@ -267,7 +267,7 @@ cown_ptr<Manager> Manager::make_manager(uint64_t buffersize, uint64_t producers,
     {
       self->pendingConsumers.emplace_back(make_unique<Consumer>(tag, consumercosts));
     }
-  };
+  });
 
   return self;
 }
@@ -280,7 +280,7 @@ void Manager::complete() {
 }
 
 void Manager::data(cown_ptr<Manager> self, unique_ptr<Producer> producer) {
-  when(self) << [producer=move(producer)](acquired_cown<Manager> self) mutable {
+  when(self) << stamped([producer=move(producer)](acquired_cown<Manager> self) mutable {
     if (self->pendingConsumers.empty()) {
       if (self->pendingData.size() >= self->adjusted)
         self->pendingProducers.push_back(move(producer));
@@ -291,11 +291,11 @@ void Manager::data(cown_ptr<Manager> self, unique_ptr<Producer> producer) {
       self->pendingConsumers.pop_front();
       Consumer::consume(move(consumer), Producer::produce(move(producer)));
     }
-  };
+  });
 }
 
 void Manager::available(cown_ptr<Manager> self, unique_ptr<Consumer> consumer) {
-  when(self) << [consumer=move(consumer)](acquired_cown<Manager> self) mutable {
+  when(self) << stamped([consumer=move(consumer)](acquired_cown<Manager> self) mutable {
     if (self->pendingData.empty()) {
       self->pendingConsumers.push_back(move(consumer));
       self->complete();
@@ -304,14 +304,14 @@ void Manager::available(cown_ptr<Manager> self, unique_ptr<Consumer> consumer) {
       self->pendingData.pop_front();
       Consumer::consume(move(consumer), item);
     }
-  };
+  });
 }
 
 void Manager::exit(cown_ptr<Manager> self) {
-  when(self) << [](acquired_cown<Manager> self)  mutable {
+  when(self) << stamped([](acquired_cown<Manager> self)  mutable {
     self->producer_count--;
     self->complete();
-  };
+  });
 }
 
 struct BndBuffer: public BocBenchmark {
@@ -21,14 +21,14 @@ struct SeriesWorker {
   SeriesWorker(double term): term(term) {}
 
   static void next(const cown_ptr<SeriesWorker>& worker, const cown_ptr<RateComputer>& computer) {
-    when(worker, computer) << [] (acquired_cown<SeriesWorker> worker, acquired_cown<RateComputer> computer) mutable {
+    when(worker, computer) << stamped([] (acquired_cown<SeriesWorker> worker, acquired_cown<RateComputer> computer) mutable {
       worker->term = computer->compute(worker->term);
-    };
+    });
   }
 };
 
 namespace LogmapMaster {
-  static void start(uint64_t terms, uint64_t series, double rate, double increment) {
+  static void start(uint64_t terms, uint64_t series, double rate, double increment, validation::Result<double>::Completion done) {
     vector<cown_ptr<SeriesWorker>> workers;
     vector<cown_ptr<RateComputer>> computers;
 
@@ -44,13 +44,27 @@ namespace LogmapMaster {
 
     cown_ptr<double> sum = make_cown<double>(0);
     for(const auto& worker: workers) {
-      when(sum, worker) << [](acquired_cown<double> sum, acquired_cown<SeriesWorker> worker) mutable {
+      when(sum, worker) << stamped([](acquired_cown<double> sum, acquired_cown<SeriesWorker> worker) mutable {
         sum += worker->term;
-      };
+      });
     }
 
-    // when(sum) << [](acquired_cown<double> sum) { std::cout << *sum << std::endl; };
-    /* done result is in sum*/
+    if (validation::wanted())
+      when(sum) << stamped([done](acquired_cown<double> sum) { done(*sum); });
+  }
+
+  static double sequential(uint64_t terms, uint64_t series, double rate, double increment) {
+    double sum = 0;
+
+    for (uint64_t j = 0; j < series; ++j) {
+      double term = (double)j * increment;
+      RateComputer computer(rate + term);
+      for (uint64_t i = 0; i < terms; ++i)
+        term = computer.compute(term);
+      sum += term;
+    }
+
+    return sum;
   }
 };
 
@@ -61,17 +75,26 @@ struct Logmap: public BocBenchmark {
   uint64_t series;
   double rate;
   double increment;
+  validation::Result<double> sum;
 
   Logmap(uint64_t terms, uint64_t series, double rate, double increment): terms(terms), series(series), rate(rate), increment(increment) {}
 
   void run() {
-    logmap::LogmapMaster::start(terms, series, rate, increment);
+    logmap::LogmapMaster::start(terms, series, rate, increment, sum.completion());
+  }
+
+  bool validates() { return true; }
+
+  std::string validate() {
+    return validation::expect_near("sum", sum.value, logmap::LogmapMaster::sequential(terms, series, rate, increment));
   }
 
   inline static const std::string name = "Logistic Map Series";
 
 };
 
+static const bool logmap_registered = register_benchmark<Logmap>(param<uint64_t>("terms", 25000), param<uint64_t>("series", 10), param<double>("rate", 3.64), param<double>("increment", 0.0025));
+
 };
 
 
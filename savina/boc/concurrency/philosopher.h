@@ -16,11 +16,10 @@ struct Table {
   Table(uint64_t philosophers): done_eating(philosophers) { }
 
   static void finished(cown_ptr<Table> self) {
-    when(self) << [](acquired_cown<Table> self) {
-      if (--(self->done_eating) == 0) {
-        return;
-      }
-    };
+    when(self) << stamped([](acquired_cown<Table> self) {
+      if (--(self->done_eating) == 0)
+        CompletionLatch::signal();
+    });
   }
 };
 
@@ -39,14 +38,14 @@ struct Philosopher {
     id(id), rounds(rounds), left(move(left)), right(move(right)), table(move(table)) {}
 
   static void eat(cown_ptr<Philosopher> phil) {
-    when(phil) << [] (acquired_cown<Philosopher> phil) {
+    when(phil) << stamped([] (acquired_cown<Philosopher> phil) {
       if (--phil->rounds >= 1) {
-        when(phil->left, phil->right) << [](acquired_cown<Fork> left, acquired_cown<Fork> right) {};
+        when(phil->left, phil->right) << stamped([](acquired_cown<Fork> left, acquired_cown<Fork> right) {});
         eat(phil.cown());
       } else {
         Table::finished(phil->table);
       }
-    };
+    });
   }
 };
 
@@ -77,4 +76,6 @@ struct DiningPhilosophers: public BocBenchmark {
   inline static const std::string name = "Dining Philosophers";
 };
 
+static const bool diningphilosophers_registered = register_benchmark<DiningPhilosophers>(param<uint64_t>("philosophers", 20), param<uint64_t>("rounds", 10000));
+
 };
\ No newline at end of file
@@ -48,22 +48,23 @@ struct Mall {
   uint64_t meeting_count;
   uint64_t sum;
   cown_ptr<Chameneo> waiting;
+  validation::Result<uint64_t>::Completion done;
 
-  Mall(uint64_t meetings, uint64_t chameneos)
-    : chameneos(chameneos), faded(0), meeting_count(meetings), sum(0) {}
+  Mall(uint64_t meetings, uint64_t chameneos, validation::Result<uint64_t>::Completion done)
+    : chameneos(chameneos), faded(0), meeting_count(meetings), sum(0), done(done) {}
 
-  static void make(uint64_t meetings, uint64_t chameneos) {
-    cown_ptr<Mall> mall = make_cown<Mall>(meetings, chameneos);
+  static void make(uint64_t meetings, uint64_t chameneos, validation::Result<uint64_t>::Completion done) {
+    cown_ptr<Mall> mall = make_cown<Mall>(meetings, chameneos, done);
     for (uint64_t i = 0; i < chameneos; ++i)
       Chameneo::make(mall, Color::factory(i % 3));
   }
 
   // No longer need to thread the color through the meeting calls (which in my opinion was an optimisation of the rendezvous in the original benchmark)
   static void meet(cown_ptr<Mall> mall, cown_ptr<Chameneo> approaching) {
-    when(mall) << [approaching=move(approaching)](acquired_cown<Mall> mall) {
-      if (mall->meeting_count > 0) {
+    when(mall) << stamped([approaching=move(approaching)](acquired_cown<Mall> mall) {
+      if (Throughput::more(mall->meeting_count > 0)) {
         if (mall->waiting) {
-          when(mall->waiting, approaching) << [](acquired_cown<Chameneo> a, acquired_cown<Chameneo> b) {
+          when(mall->waiting, approaching) << stamped([](acquired_cown<Chameneo> a, acquired_cown<Chameneo> b) {
             a->color = b->color = Color::complement(a->color, b->color);
 
             a->meeting_count++;
@@ -71,24 +72,25 @@ struct Mall {
 
             b->meeting_count++;
             Mall::meet(b->mall, b.cown());
-          };
+          });
 
           mall->meeting_count--;
+          Throughput::completed();
           mall->waiting = nullptr;
         } else {
           mall->waiting = move(approaching);
         }
       } else {
 
-        when(mall.cown(), approaching) << [](acquired_cown<Mall> mall, acquired_cown<Chameneo> approaching) {
+        when(mall.cown(), approaching) << stamped([](acquired_cown<Mall> mall, acquired_cown<Chameneo> approaching) {
           approaching->color = ChameneoColor::Faded;
           mall->sum += approaching->meeting_count;
           if (++mall->faded == mall->chameneos) {
-            /* done */
+            mall->done(mall->sum);
           }
-        };
+        });
       }
-    };
+    });
   }
 };
 
@@ -102,12 +104,22 @@ void Chameneo::make(cown_ptr<Mall> mall, ChameneoColor color) {
 struct Chameneos: public BocBenchmark {
   uint64_t meetings;
   uint64_t chameneos;
+  validation::Result<uint64_t> met;
 
   Chameneos(uint64_t chameneos, uint64_t meetings): meetings(meetings), chameneos(chameneos) {}
 
-  void run() { chameneos::Mall::make(meetings, chameneos); }
+  void run() { chameneos::Mall::make(meetings, chameneos, met.completion()); }
+
+  bool continuous() { return true; }
+
+  bool validates() { return true; }
+
+  // Each meeting is counted by both chameneos that took part.
+  std::string validate() { return validation::expect("meetings counted", met.value, 2 * meetings); }
 
   inline static const std::string name = "Chameneos";
 };
 
+static const bool chameneos_registered = register_benchmark<Chameneos>(param<uint64_t>("chameneos", 100), param<uint64_t>("meetings", 200000));
+
 };
\ No newline at end of file
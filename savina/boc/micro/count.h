@@ -19,15 +19,15 @@ struct Producer {
 
   Producer(uint64_t messages): messages(messages) { }
 
-  static void make(cown_ptr<Counter> counter, uint64_t messages) {
+  static void make(cown_ptr<Counter> counter, uint64_t messages, validation::Result<uint64_t>::Completion done) {
     for (uint64_t i = 0; i < messages; ++i) {
-      when(counter) << [](acquired_cown<Counter> counter) { counter->count++; };
+      when(counter) << stamped([](acquired_cown<Counter> counter) { counter->count++; });
     }
 
     cown_ptr<Producer> producer = make_cown<Producer>(messages);
-    when(counter, producer) << [](acquired_cown<Counter> counter, acquired_cown<Producer> producer) {
-      /* done */
-    };
+    when(counter, producer) << stamped([done](acquired_cown<Counter> counter, acquired_cown<Producer> producer) {
+      done(counter->count);
+    });
   }
 };
 
@@ -35,13 +35,20 @@ struct Producer {
 
 struct Count: BocBenchmark {
   uint64_t messages;
+  validation::Result<uint64_t> result;
 
   Count(uint64_t messages): messages(messages) {}
 
-  void run() { count::Producer::make(make_cown<count::Counter>(), messages); }
+  void run() { count::Producer::make(make_cown<count::Counter>(), messages, result.completion()); }
+
+  bool validates() { return true; }
+
+  std::string validate() { return validation::expect("count", result.value, messages); }
 
   inline static const std::string name = "Count";
 
 };
 
+static const bool count_registered = register_benchmark<Count>(param<uint64_t>("messages", 1000000));
+
 };
\ No newline at end of file
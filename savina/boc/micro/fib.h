@@ -18,24 +18,45 @@ struct Fibonacci {
       return make_cown<uint64_t>(uint64_t{1});
     } else {
       cown_ptr<uint64_t> f1 = Fibonacci::compute(n - 1);
-      when(f1, Fibonacci::compute(n - 2)) << [](acquired_cown<uint64_t> f1, acquired_cown<uint64_t> f2) { *f1 += * f2; };
+      when(f1, Fibonacci::compute(n - 2)) << stamped([](acquired_cown<uint64_t> f1, acquired_cown<uint64_t> f2) { *f1 += * f2; });
       return f1;
     }
   }
 
+  static uint64_t sequential(uint64_t n) {
+    uint64_t previous = 1;
+    uint64_t current = 1;
+    for (uint64_t i = 2; i < n; i++)
+      previous = std::exchange(current, current + previous);
+    return current;
+  }
+
 };
 
 };
 
 struct Fib: public BocBenchmark {
   uint64_t index;
+  validation::Result<uint64_t> result;
 
   Fib(uint64_t index): index(index) {}
 
-  void run() { fib::Fibonacci::compute(index); }
+  void run() {
+    cown_ptr<uint64_t> f = fib::Fibonacci::compute(index);
+    if (validation::wanted())
+      when(f) << stamped([done=result.completion()](acquired_cown<uint64_t> f) { done(*f); });
+  }
+
+  bool validates() { return true; }
+
+  std::string validate() {
+    return validation::expect("fib(" + std::to_string(index) + ")", result.value, fib::Fibonacci::sequential(index));
+  }
 
   inline static const std::string name = "Fib";
 
 };
 
+static const bool fib_registered = register_benchmark<Fib>(param<uint64_t>("index", 25));
+
 };
\ No newline at end of file
@@ -14,10 +14,10 @@ struct Token {};
 struct ForkJoin {
   static cown_ptr<ForkJoin> make(Token token) {
     auto worker = make_cown<ForkJoin>();
-    when(worker) << [](acquired_cown<ForkJoin>) { // this isn't forking, it's all done in one thread
+    when(worker) << stamped([](acquired_cown<ForkJoin>) { // this isn't forking, it's all done in one thread
       double n = sin(double(37.2));
       double r = n * n;
-    };
+    });
     return worker;
   }
 };
@@ -36,9 +36,10 @@ struct ForkJoinMaster {
     }
 
     for (const auto& worker: fjs) {
-      when(master, worker) << [](acquired_cown<ForkJoinMaster> master, acquired_cown<ForkJoin> worker) {
-        master->workers--;
-      };
+      when(master, worker) << stamped([](acquired_cown<ForkJoinMaster> master, acquired_cown<ForkJoin> worker) {
+        if (--master->workers == 0)
+          CompletionLatch::signal();
+      });
     }
   }
 };
@@ -55,4 +56,6 @@ struct Fjcreate: public BocBenchmark {
   inline static const std::string name = "Fork-Join Create";
 };
 
+static const bool fjcreate_registered = register_benchmark<Fjcreate>(param<uint64_t>("workers", 40000));
+
 };
\ No newline at end of file
@@ -23,12 +23,13 @@ struct Throughput {
 };
 
 struct FjthrMaster {
+  // Throughputs still to join, each once all of its messages have run.
   uint64_t total;
 
-  FjthrMaster(uint64_t messages, uint64_t actors): total(messages * actors) {}
+  FjthrMaster(uint64_t actors): total(actors) {}
 
   static void make(uint64_t messages, uint64_t actors, uint64_t channels, bool priorities) {
-    cown_ptr<FjthrMaster> master = make_cown<FjthrMaster>(messages, actors);
+    cown_ptr<FjthrMaster> master = make_cown<FjthrMaster>(actors);
     vector<cown_ptr<Throughput>> throughputs;
 
     for (uint64_t i = 0; i < actors; ++i) {
@@ -42,9 +43,9 @@ struct FjthrMaster {
     }
 
     for(const cown_ptr<Throughput>& k: throughputs) {
-      when(master, k) << [](acquired_cown<FjthrMaster> master, acquired_cown<Throughput> k){
-        if (--master->total) { /* done */ }
-      };
+      when(master, k) << stamped([](acquired_cown<FjthrMaster> master, acquired_cown<Throughput> k){
+        if (--master->total == 0) CompletionLatch::signal();
+      });
     }
     /*
     when(throughputs) {
@@ -55,10 +56,10 @@ struct FjthrMaster {
 };
 
 void Throughput::compute(cown_ptr<Throughput> throughput) {
-  when(throughput) << [](acquired_cown<Throughput> throughput) {
+  when(throughput) << stamped([](acquired_cown<Throughput> throughput) {
     double n = sin(37.2);
     double r = n * n;
-  };
+  });
 }
 
 };
@@ -77,4 +78,6 @@ struct Fjthrput: public BocBenchmark {
   inline static const std::string name = "Fork-Join Throughput";
 };
 
+static const bool fjthrput_registered = register_benchmark<Fjthrput>(param<uint64_t>("messages", 10000), param<uint64_t>("actors", 60), param<uint64_t>("channels", 1), param<bool>("priorities", true));
+
 };
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include <cpp/when.h>
+#include "util/bench.h"
+#include <vector>
+
+namespace boc_benchmark {
+
+// The fixed cost of the runtime rather than of a benchmark, which short runs
+// pay every time. With --phases, init_ms is Scheduler::init() and
+// shutdown_ms the runtime stopping once the behaviour is done, and with
+// --completion, result_ms is from spawning the first behaviour until it runs
+// and teardown_ms the rest of sched.run(), including releasing the live
+// cowns. --cores shows how each grows with the number of workers.
+struct Startup: public BocBenchmark {
+  uint64_t cowns;
+  // Created in setup(), outside the timed region, and released by the
+  // first behaviour.
+  std::vector<cown_ptr<uint64_t>> live;
+
+  Startup(uint64_t cowns): cowns(cowns) {}
+
+  void setup() {
+    live.clear();
+    live.reserve(cowns);
+    for (uint64_t i = 0; i < cowns; ++i)
+      live.push_back(make_cown<uint64_t>(i));
+  }
+
+  void run() {
+    when(make_cown<uint64_t>(0)) << stamped([live=std::move(live)](acquired_cown<uint64_t>) mutable {
+      CompletionLatch::signal();
+      live.clear();
+    });
+  }
+
+  inline static const std::string name = "Startup";
+};
+
+// Fixed sizes, so that --param cowns=N, which resizes Startup, can't leave
+// these running with a size their names don't match.
+struct StartupThousand: public Startup {
+  StartupThousand(): Startup(1000) {}
+
+  inline static const std::string name = "Startup 1K Cowns";
+};
+
+struct StartupMillion: public Startup {
+  StartupMillion(): Startup(1000000) {}
+
+  inline static const std::string name = "Startup 1M Cowns";
+};
+
+static const bool startup_registered = register_benchmark<Startup>(param<uint64_t>("cowns", 0));
+static const bool startup_thousand_registered = register_benchmark<StartupThousand>();
+static const bool startup_million_registered = register_benchmark<StartupMillion>();
+
+};
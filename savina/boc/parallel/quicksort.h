@@ -1,6 +1,7 @@
 #include <cpp/when.h>
 #include <util/bench.h>
 #include <util/random.h>
+#include <algorithm>
 #include <cmath>
 #include <unordered_map>
 
@@ -58,9 +59,9 @@ namespace Sorter {
 
     if (size < threshold){
       cown_ptr<vector<uint64_t>> result = make_cown<vector<uint64_t>>();
-      when(result) << [input=move(input)](acquired_cown<vector<uint64_t>> result) {
+      when(result) << stamped([input=move(input)](acquired_cown<vector<uint64_t>> result) {
         *result = sort_sequentially(move(input));
-      };
+      });
       return result;
     } else {
       uint64_t pivot = input[size / 2];
@@ -72,10 +73,10 @@ namespace Sorter {
 
       auto left = Sorter::sort(move(l), threshold);
       auto right = Sorter::sort(move(r), threshold);
-      when(left, right) << [p=move(p)] (acquired_cown<vector<uint64_t>> l, acquired_cown<vector<uint64_t>> r) {
+      when(left, right) << stamped([p=move(p)] (acquired_cown<vector<uint64_t>> l, acquired_cown<vector<uint64_t>> r) {
         l->insert(l->end(), p.begin(), p.end());
         l->insert(l->end(), r->begin(), r->end());
-      };
+      });
 
       return left;
     }
@@ -89,30 +90,51 @@ struct Quicksort: public BocBenchmark {
   uint64_t max;
   uint64_t threshold;
   uint64_t seed;
+  std::vector<uint64_t> data;
+  validation::Result<std::vector<uint64_t>> sorted;
+  // The input sorted sequentially, computed on the first --validate.
+  std::vector<uint64_t> expected;
 
   Quicksort(uint64_t dataset, uint64_t max, uint64_t threshold, uint64_t seed):
     dataset(dataset), max(max), threshold(threshold), seed(seed) {}
 
-
-  void run() {
-    using namespace std;
-
-    vector<uint64_t> data;
+  std::vector<uint64_t> generate() {
     SimpleRand random(seed);
+    std::vector<uint64_t> input;
 
     for (uint64_t i = 0; i < dataset; ++i) {
-      data.push_back(random.nextLong() % max);
+      input.push_back(random.nextLong() % max);
     }
 
+    return input;
+  }
+
+  void setup() {
+    data = generate();
+  }
+
+  void run() {
+    using namespace std;
     using namespace quicksort;
     cown_ptr<vector<uint64_t>> result = move(Sorter::sort(move(data), threshold));
-    // when(result) << [dataset = dataset](acquired_cown<vector<uint64_t>> result) {
-    //   assert(result->size() == dataset);
-    //   assert(is_sorted(result->begin(), result->end()));
-    // };
+    if (validation::wanted())
+      when(result) << stamped([done=sorted.completion()](acquired_cown<vector<uint64_t>> result) { done(move(*result)); });
+  }
+
+  bool validates() { return true; }
+
+  std::string validate() {
+    if (expected.size() != dataset) {
+      expected = generate();
+      std::sort(expected.begin(), expected.end());
+    }
+
+    return validation::expect_elements("sorted", sorted.value, expected);
   }
 
   inline static const std::string name = "Quicksort";
 };
 
+static const bool quicksort_registered = register_benchmark<Quicksort>(param<uint64_t>("dataset", 1000000), param<uint64_t>("max", uint64_t(1) << 60), param<uint64_t>("threshold", 2048), param<uint64_t>("seed", 1024));
+
 };
\ No newline at end of file
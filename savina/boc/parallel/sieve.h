@@ -30,9 +30,9 @@ namespace boc_benchmark
       {
         if (next)
         {
-          when (next) << [i, f=std::move(f)](acquired_cown<Block> next) mutable {
+          when (next) << stamped([i, f=std::move(f)](acquired_cown<Block> next) mutable {
             next->apply(i, std::move(f));
-          };
+          });
         }
       }
     }
@@ -77,19 +77,20 @@ namespace boc_benchmark
       for (size_t i = count - 1;; i--)
       {
         uint64_t base = i * buffersize;
-        uint64_t size = std::min(buffersize, size - base);
-        prev = make_cown<Block>(base, size, prev);
+        prev = make_cown<Block>(base, std::min(buffersize, size - base), prev);
         if (i == 0)
           break;
       }
 
-      when(prev) << [this](acquired_cown<Block> prev) mutable
+      when(prev) << stamped([this](acquired_cown<Block> prev) mutable
       {
         prev->iterate(2);
-      };
+      });
     }
 
     inline static const std::string name = "Sieve of Eratosthenes";
   };
 
+  static const bool sieve_registered = register_benchmark<Sieve>(param<uint64_t>("size", 100000), param<uint64_t>("buffersize", 1000));
+
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ using namespace std;
 
 namespace Worker {
   cown_ptr<double> create(double left, double right, double precision);
+  double integrate(double left, double right, double precision);
 };
 
 namespace Master {
@@ -23,8 +24,8 @@ namespace Master {
 
     std::vector<cown_ptr<double>> partial_results;
     for (uint64_t i = 0; i < workers; ++i) {
-      left += (range * i);
-      partial_results.emplace_back(Worker::create(left, left + range, precision));
+      double start = left + (range * i);
+      partial_results.emplace_back(Worker::create(start, start + range, precision));
     }
 
 //#if true
@@ -33,9 +34,9 @@ namespace Master {
    // - second creates a tree like reduction, has more parallelism but more messages
     auto pr = partial_results.begin();
     while (++pr != partial_results.end()) {
-      when(*partial_results.begin(), *pr) << [](acquired_cown<double> r, acquired_cown<double> pr) {
+      when(*partial_results.begin(), *pr) << stamped([](acquired_cown<double> r, acquired_cown<double> pr) {
         *r += *pr;
-      };
+      });
     }
 // #else
 //     uint64_t its = ceil(log2(partial_results.size() + 1));
@@ -65,26 +66,35 @@ namespace Fx {
   }
 }
 
-// Question: is new in Pony async?? because this method was the actor constructor.
-cown_ptr<double> Worker::create(double left, double right, double precision) {
-  auto result = make_cown<double>();
-  when(result) << [left, right, precision](acquired_cown<double> result) mutable {
-    double n = ((right - left) / precision);
-    *result = 0.0;
+double Worker::integrate(double left, double right, double precision) {
+  // A whole number of pieces, so that each worker covers its share of the
+  // range exactly rather than integrating a piece beyond it.
+  double n = std::max(1.0, std::round((right - left) / precision));
+  precision = (right - left) / n;
+  double area = 0.0;
 
-    double i = 0.0;
-    while (i < n) {
-      auto lx = (i * precision) + left;
-      auto rx = lx + precision;
+  double i = 0.0;
+  while (i < n) {
+    auto lx = (i * precision) + left;
+    auto rx = lx + precision;
 
-      auto ly = Fx::apply(lx);
-      auto ry = Fx::apply(rx);
+    auto ly = Fx::apply(lx);
+    auto ry = Fx::apply(rx);
 
-      *result += (0.5 * (ly + ry) * precision);
+    area += (0.5 * (ly + ry) * precision);
 
-      i++;
-    }
-  };
+    i++;
+  }
+
+  return area;
+}
+
+// Question: is new in Pony async?? because this method was the actor constructor.
+cown_ptr<double> Worker::create(double left, double right, double precision) {
+  auto result = make_cown<double>();
+  when(result) << stamped([left, right, precision](acquired_cown<double> result) mutable {
+    *result = integrate(left, right, precision);
+  });
   return result;
 }
 
@@ -96,13 +106,40 @@ struct Trapezoid: public BocBenchmark {
   uint64_t left;
   uint64_t right;
   double precision;
+  validation::Result<double> area;
+  // The integral by Simpson's rule and how far the trapezoid rule may be from
+  // it, computed on the first --validate.
+  std::optional<double> expected;
+  double tolerance = 0;
 
   Trapezoid(uint64_t pieces, uint64_t workers, uint64_t left, uint64_t right):
     pieces(pieces), workers(workers), left(left), right(right), precision(double(right - left) / (double)pieces) {}
 
-  void run() { trapezoid::Master::create(workers, left, right, precision); }
+  void run() {
+    cown_ptr<double> total = trapezoid::Master::create(workers, left, right, precision);
+    if (validation::wanted())
+      when(total) << stamped([done=area.completion()](acquired_cown<double> total) { done(*total); });
+  }
+
+  bool validates() { return true; }
+
+  std::string validate() {
+    // Savina's integrand, written out again rather than taken from the
+    // workers so that a mistake in theirs is caught. The trapezoid rule is
+    // off by about h^2 / 12 (f'(right) - f'(left)), so twice that is allowed.
+    if (!expected) {
+      auto f = [](double x) { return std::sin(x * x * x - 1) / (x + 1) * std::sqrt(1 + std::exp(std::sqrt(2 * x))); };
+      auto slope = [&](double x) { return (f(x + 1e-5) - f(x - 1e-5)) / 2e-5; };
+      expected = validation::simpson(f, left, right, uint64_t(1) << 21);
+      tolerance = 1e-9 + 2 * std::abs(precision * precision / 12 * (slope(right) - slope(left)));
+    }
+
+    return validation::expect_near("area", area.value, *expected, tolerance);
+  }
 
   inline static const std::string name = "Trapezoid";
 };
 
+static const bool trapezoid_registered = register_benchmark<Trapezoid>(param<uint64_t>("pieces", 10000000), param<uint64_t>("workers", 100), param<uint64_t>("left", 1), param<uint64_t>("right", 5));
+
 };
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "util/bench.h"
+
+#include <algorithm>
+
+// main() for every executable, built into the savina-harness libraries. It
+// runs whatever benchmarks are linked in: savina.cpp includes all of them,
+// and each standalone executable a single header, so --benchmark is only
+// needed to pick one out of the combined driver.
+
+static bool iequals(const std::string& a, const std::string& b)
+{
+    return std::equal(a.begin(), a.end(),
+                      b.begin(), b.end(),
+                      [](char a, char b) {
+                          return tolower(a) == tolower(b);
+                      });
+}
+
+static void run_all(BenchmarkHarness& savina, const std::string& paradigm, const std::string& benchmark) {
+  for (const RegisteredBenchmark& registered: Registry::get())
+    if (registered.paradigm == paradigm && (benchmark.empty() || iequals(benchmark, registered.name)))
+      savina.run(registered);
+}
+
+// A standalone executable only has benchmarks of one paradigm.
+static bool standalone() {
+  for (const RegisteredBenchmark& registered: Registry::get())
+    if (registered.paradigm != Registry::get().front().paradigm)
+      return false;
+  return !Registry::get().empty();
+}
+
+int main(const int argc, const char** argv) {
+  BenchmarkHarness savina(argc, argv);
+
+  if (savina.opt.has("--list"))
+  {
+    std::cout << "Benchmarks:\n";
+    for (const RegisteredBenchmark& registered: Registry::get()) {
+      std::cout << "\t" << registered.paradigm << "\t" << registered.name;
+      for (const Parameter& parameter: registered.parameters)
+        std::cout << " " << parameter.name << "=" << parameter.value;
+      std::cout << "\n";
+    }
+    return 0;
+  }
+
+  std::string benchmark = savina.opt.is("--benchmark", "");
+
+  // --compare interleaves the actor and BoC versions of each benchmark,
+  // --compare-pair paradigm:name,paradigm:name any two benchmarks.
+  if (savina.opt.has("--compare") || savina.opt.has("--compare-pair"))
+  {
+    if (savina.isolation)
+      std::cout << "WARNING: --isolate is ignored with --compare" << std::endl;
+    if (savina.opt.has("--csv"))
+      BenchmarkHarness::compare_header();
+
+    if (savina.opt.has("--compare-pair")) {
+      std::string pair = savina.opt.is("--compare-pair", "");
+      size_t comma = pair.find(',');
+      const RegisteredBenchmark* sides[2] = {nullptr, nullptr};
+      std::string names[2] = {pair.substr(0, comma), comma == std::string::npos ? "" : pair.substr(comma + 1)};
+      for (size_t i = 0; i < 2; i++) {
+        size_t colon = names[i].find(':');
+        for (const RegisteredBenchmark& registered: Registry::get())
+          if (colon != std::string::npos && registered.paradigm == names[i].substr(0, colon) && iequals(registered.name, names[i].substr(colon + 1)))
+            sides[i] = &registered;
+        if (sides[i] == nullptr) {
+          std::cerr << "ERROR: --compare-pair expects paradigm:name,paradigm:name of registered benchmarks, got " << pair << std::endl;
+          return 1;
+        }
+      }
+      savina.compare(*sides[0], *sides[1]);
+    } else {
+      for (const RegisteredBenchmark& actor: Registry::get()) {
+        const RegisteredBenchmark* boc = Registry::find("boc", actor.name);
+        if (actor.paradigm == "actor" && boc != nullptr && (benchmark.empty() || iequals(benchmark, actor.name)))
+          savina.compare(actor, *boc);
+      }
+    }
+
+    return savina.status();
+  }
+
+  if (savina.opt.has("--actor"))
+    run_all(savina, "actor", benchmark);
+
+  if (savina.opt.has("--full"))
+    run_all(savina, "boc", benchmark);
+
+  // Which is all there is to run in a standalone executable.
+  if (!savina.opt.has("--actor") && !savina.opt.has("--full") && !savina.opt.has("--scale") && standalone())
+    run_all(savina, Registry::get().front().paradigm, benchmark);
+
+  // With no paradigm selected, --scale sweeps the busy-waiting Banking.
+  if (savina.opt.has("--scale") && !savina.opt.has("--actor") && !savina.opt.has("--full"))
+  {
+    // BoC
+    const RegisteredBenchmark* banking = Registry::find("boc", "Banking");
+    if (banking != nullptr && (benchmark.empty() || iequals(benchmark, banking->name)))
+      savina.run(banking->with("busy_wait", "true"));
+  }
+
+  return savina.status();
+}
\ No newline at end of file
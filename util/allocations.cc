@@ -0,0 +1,69 @@
+#include <cstddef>
+#include "allocations.h"
+
+// Wrappers for every operator new, installed by linking with
+// -Wl,--wrap=<symbol> (see savina/CMakeLists.txt). Each counts the request,
+// attributes it to its caller for --alloc-profile, and forwards to the real operator new, which is snmalloc's new.cc override
+// in savina and savina-stats and the C++ runtime's in savina-sys.
+//
+// align_val_t and nothrow_t are passed as size_t and a pointer respectively,
+// which is how the Itanium C++ ABI passes them.
+
+extern "C" {
+  void* __real__Znwm(size_t size);
+  void* __real__Znam(size_t size);
+  void* __real__ZnwmRKSt9nothrow_t(size_t size, const void* tag);
+  void* __real__ZnamRKSt9nothrow_t(size_t size, const void* tag);
+  void* __real__ZnwmSt11align_val_t(size_t size, size_t alignment);
+  void* __real__ZnamSt11align_val_t(size_t size, size_t alignment);
+  void* __real__ZnwmSt11align_val_tRKSt9nothrow_t(size_t size, size_t alignment, const void* tag);
+  void* __real__ZnamSt11align_val_tRKSt9nothrow_t(size_t size, size_t alignment, const void* tag);
+
+  void* __wrap__Znwm(size_t size) {
+    AllocationCounter::record(size);
+    AllocationProfile::record(size, __builtin_return_address(0));
+    return __real__Znwm(size);
+  }
+
+  void* __wrap__Znam(size_t size) {
+    AllocationCounter::record(size);
+    AllocationProfile::record(size, __builtin_return_address(0));
+    return __real__Znam(size);
+  }
+
+  void* __wrap__ZnwmRKSt9nothrow_t(size_t size, const void* tag) {
+    AllocationCounter::record(size);
+    AllocationProfile::record(size, __builtin_return_address(0));
+    return __real__ZnwmRKSt9nothrow_t(size, tag);
+  }
+
+  void* __wrap__ZnamRKSt9nothrow_t(size_t size, const void* tag) {
+    AllocationCounter::record(size);
+    AllocationProfile::record(size, __builtin_return_address(0));
+    return __real__ZnamRKSt9nothrow_t(size, tag);
+  }
+
+  void* __wrap__ZnwmSt11align_val_t(size_t size, size_t alignment) {
+    AllocationCounter::record(size);
+    AllocationProfile::record(size, __builtin_return_address(0));
+    return __real__ZnwmSt11align_val_t(size, alignment);
+  }
+
+  void* __wrap__ZnamSt11align_val_t(size_t size, size_t alignment) {
+    AllocationCounter::record(size);
+    AllocationProfile::record(size, __builtin_return_address(0));
+    return __real__ZnamSt11align_val_t(size, alignment);
+  }
+
+  void* __wrap__ZnwmSt11align_val_tRKSt9nothrow_t(size_t size, size_t alignment, const void* tag) {
+    AllocationCounter::record(size);
+    AllocationProfile::record(size, __builtin_return_address(0));
+    return __real__ZnwmSt11align_val_tRKSt9nothrow_t(size, alignment, tag);
+  }
+
+  void* __wrap__ZnamSt11align_val_tRKSt9nothrow_t(size_t size, size_t alignment, const void* tag) {
+    AllocationCounter::record(size);
+    AllocationProfile::record(size, __builtin_return_address(0));
+    return __real__ZnamSt11align_val_tRKSt9nothrow_t(size, alignment, tag);
+  }
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Counts calls to operator new, and the bytes requested, while enabled.
+//
+// The savina targets are linked with --wrap for every operator new, sending
+// them through util/allocations.cc, which calls record() before handing over
+// to the real allocator. Behaviours and cowns are allocated by the runtime
+// directly from snmalloc rather than with new, so they are not counted here,
+// only in the allocator's own usage.
+struct AllocationCounter {
+  static constexpr size_t SLOTS = 256;
+
+  // Each thread claims a slot, so the counts are updated without contention.
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> bytes;
+  };
+
+  inline static std::atomic<bool> enabled{false};
+  inline static Slot slots[SLOTS];
+  inline static std::atomic<size_t> next_slot{0};
+
+  static void record(size_t size) {
+    if (!enabled.load(std::memory_order_relaxed))
+      return;
+
+    thread_local size_t index = next_slot.fetch_add(1, std::memory_order_relaxed) % SLOTS;
+    slots[index].count.fetch_add(1, std::memory_order_relaxed);
+    slots[index].bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  static void start() {
+    for (Slot& slot: slots) {
+      slot.count.store(0, std::memory_order_relaxed);
+      slot.bytes.store(0, std::memory_order_relaxed);
+    }
+    enabled.store(true, std::memory_order_release);
+  }
+
+  // Only call once the scheduler has stopped.
+  static std::pair<uint64_t, uint64_t> stop() {
+    enabled.store(false, std::memory_order_release);
+
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    for (Slot& slot: slots) {
+      count += slot.count.load(std::memory_order_relaxed);
+      bytes += slot.bytes.load(std::memory_order_relaxed);
+    }
+    return {count, bytes};
+  }
+};
+
+// Allocations attributed to where they came from, selected with
+// --alloc-profile <file>.
+//
+// Every operator new is recorded against its caller, from the return address
+// the wrapper sees, and against the stamped() behaviour running on the thread
+// at the time, if any. stamped() also records the closure each behaviour
+// captures when it is scheduled, under the behaviour's lambda type; the
+// runtime allocates the behaviour around it from snmalloc directly, so that
+// part is not seen by the wrappers. Each site keeps counts, bytes and a
+// histogram of request sizes in powers of two.
+//
+// The sites live in a fixed open-addressed table, as the recording path can't
+// allocate. Symbols are resolved with dladdr(), which needs the executable to
+// export them (ENABLE_EXPORTS, see savina/CMakeLists.txt); the module offset
+// printed with each site can always be given to addr2line.
+struct AllocationProfile {
+  static constexpr size_t SITES = 4096;
+  static constexpr size_t PROBES = 64;
+  // Requests of up to 2^i bytes go in size bucket i, the last takes the rest.
+  static constexpr size_t SIZES = 24;
+
+  struct Site {
+    std::atomic<uint64_t> key;
+    std::atomic<uintptr_t> caller;
+    std::atomic<const char*> behaviour;
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> bytes;
+    std::atomic<uint64_t> sizes[SIZES];
+  };
+
+  inline static std::atomic<bool> enabled{false};
+  inline static Site sites[SITES];
+  // Requests that found no free site.
+  inline static std::atomic<uint64_t> dropped{0};
+  // Runs recorded since reset().
+  inline static uint64_t runs = 0;
+  // The mangled lambda type of the stamped() behaviour running on this thread.
+  inline static thread_local const char* current = nullptr;
+
+  static void record(size_t size, const void* caller) {
+    if (enabled.load(std::memory_order_relaxed))
+      add((uintptr_t)caller, current, size);
+  }
+
+  static void closure(const char* behaviour, size_t size) {
+    if (enabled.load(std::memory_order_relaxed))
+      add(0, behaviour, size);
+  }
+
+  static void add(uintptr_t caller, const char* behaviour, size_t size) {
+    // Never 0, which marks an empty site.
+    uint64_t key = ((caller * 0x9E3779B97F4A7C15ull) ^ (uint64_t)(uintptr_t)behaviour) | 1;
+    uint64_t hash = key ^ (key >> 29);
+
+    for (size_t probe = 0; probe < PROBES; probe++) {
+      Site& site = sites[(hash + probe) % SITES];
+      uint64_t existing = site.key.load(std::memory_order_acquire);
+
+      if (existing == 0) {
+        if (site.key.compare_exchange_strong(existing, key, std::memory_order_acq_rel)) {
+          site.caller.store(caller, std::memory_order_relaxed);
+          site.behaviour.store(behaviour, std::memory_order_relaxed);
+          existing = key;
+        }
+      }
+
+      if (existing != key)
+        continue;
+
+      size_t bucket = (size <= 1) ? 0 : std::min<size_t>(64 - __builtin_clzll(size - 1), SIZES - 1);
+      site.count.fetch_add(1, std::memory_order_relaxed);
+      site.bytes.fetch_add(size, std::memory_order_relaxed);
+      site.sizes[bucket].fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Sets the current behaviour for as long as it is in scope.
+  struct Scope {
+    const char* previous;
+
+    Scope(const char* behaviour): previous(current) { current = behaviour; }
+
+    ~Scope() { current = previous; }
+  };
+
+  static void reset() {
+    for (Site& site: sites) {
+      site.key.store(0, std::memory_order_relaxed);
+      site.count.store(0, std::memory_order_relaxed);
+      site.bytes.store(0, std::memory_order_relaxed);
+      for (auto& size: site.sizes)
+        size.store(0, std::memory_order_relaxed);
+    }
+    dropped.store(0, std::memory_order_relaxed);
+    runs = 0;
+  }
+
+  static void start() {
+    runs++;
+    enabled.store(true, std::memory_order_release);
+  }
+
+  static void stop() {
+    enabled.store(false, std::memory_order_release);
+  }
+
+  static std::string demangle(const char* name) {
+    int status = 0;
+    char* readable = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status != 0 || readable == nullptr)
+      return name;
+
+    std::string result = readable;
+    std::free(readable);
+    return result;
+  }
+
+  // The function the caller is in, and where in which module.
+  static std::string symbolize(uintptr_t caller) {
+    Dl_info info;
+    if (dladdr((void*)caller, &info) == 0 || info.dli_fname == nullptr)
+      return "unknown";
+
+    std::string module = info.dli_fname;
+    module = module.substr(module.rfind('/') + 1);
+
+    char offset[32];
+    std::snprintf(offset, sizeof(offset), "+0x%zx", (size_t)(caller - (uintptr_t)info.dli_fbase));
+    std::string where = "(" + module + offset + ")";
+
+    if (info.dli_sname == nullptr)
+      return where;
+
+    return demangle(info.dli_sname) + " " + where;
+  }
+
+  // Writes the sites with the most bytes, with everything averaged per run,
+  // once the scheduler has stopped.
+  static void report(std::ostream& out, const std::string& benchmark, const std::string& paradigm, size_t shown = 25) {
+    std::vector<const Site*> used;
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    for (const Site& site: sites) {
+      if (site.key.load(std::memory_order_relaxed) == 0)
+        continue;
+      used.push_back(&site);
+      count += site.count.load(std::memory_order_relaxed);
+      bytes += site.bytes.load(std::memory_order_relaxed);
+    }
+
+    std::sort(used.begin(), used.end(), [](const Site* a, const Site* b) {
+      return a->bytes.load(std::memory_order_relaxed) > b->bytes.load(std::memory_order_relaxed);
+    });
+
+    auto per_run = [](uint64_t total) { return (uint64_t)std::llround((double)total / (double)std::max<uint64_t>(runs, 1)); };
+    out << benchmark << " (" << paradigm << "): " << per_run(count) << " allocations, "
+        << per_run(bytes) << " bytes per run over " << runs << " runs\n";
+    if (dropped.load(std::memory_order_relaxed) > 0)
+      out << "  " << dropped.load(std::memory_order_relaxed) << " allocations were not attributed, the site table was full\n";
+
+    for (size_t i = 0; i < std::min(used.size(), shown); i++) {
+      const Site& site = *used[i];
+      uint64_t site_count = site.count.load(std::memory_order_relaxed);
+      uint64_t site_bytes = site.bytes.load(std::memory_order_relaxed);
+      uintptr_t caller = site.caller.load(std::memory_order_relaxed);
+      const char* behaviour = site.behaviour.load(std::memory_order_relaxed);
+
+      out << "  " << per_run(site_count) << " allocations, " << per_run(site_bytes) << " bytes, "
+          << (site_bytes / std::max<uint64_t>(site_count, 1)) << " bytes each\n";
+      if (caller == 0)
+        out << "    closure of behaviour " << demangle(behaviour) << "\n";
+      else
+        out << "    in " << symbolize(caller) << "\n";
+      if (caller != 0 && behaviour != nullptr)
+        out << "    while running " << demangle(behaviour) << "\n";
+
+      out << "    sizes";
+      for (size_t b = 0; b < SIZES; b++) {
+        uint64_t n = site.sizes[b].load(std::memory_order_relaxed);
+        if (n == 0)
+          continue;
+        if (b + 1 == SIZES)
+          out << " >" << (1ull << (b - 1)) << ":" << per_run(n);
+        else
+          out << " <=" << (1ull << b) << ":" << per_run(n);
+      }
+      out << "\n";
+    }
+
+    if (used.size() > shown)
+      out << "  and " << (used.size() - shown) << " more sites\n";
+    out << std::endl;
+  }
+};
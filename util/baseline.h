@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "json.h"
+#include "registry.h"
+#include "stats.h"
+
+// Results loaded from a file written by an earlier run with --json, which the
+// current run is compared against with --baseline <file>.
+//
+// For each core count both runs have samples for, the difference is tested
+// with Mann-Whitney U and the ratio of medians (current / baseline) is given
+// with a bootstrap confidence interval. A change is significant when the test
+// rejects at --alpha (default 0.05), the interval excludes 1 and the ratio is
+// more than --threshold percent (default 0) from 1.
+struct Baseline {
+  struct Result {
+    std::string name;
+    std::string paradigm;
+    std::vector<Parameter> parameters;
+    std::vector<std::pair<size_t, std::vector<double>>> runs;
+  };
+
+  std::vector<Result> results;
+  double alpha;
+  double threshold;
+  size_t regressions = 0;
+
+  Baseline(const std::string& filename, double alpha, double threshold): alpha(alpha), threshold(threshold) {
+    std::ifstream in(filename);
+    if (!in) {
+      std::cerr << "ERROR: could not open baseline " << filename << std::endl;
+      std::exit(1);
+    }
+
+    std::stringstream contents;
+    contents << in.rdbuf();
+
+    JSONValue root;
+    const JSONValue* benchmarks = nullptr;
+    if (JSONValue::parse(contents.str(), root))
+      benchmarks = root.get("benchmarks");
+
+    if (benchmarks == nullptr || benchmarks->kind != JSONValue::Array) {
+      std::cerr << "ERROR: " << filename << " is not a results file written with --json" << std::endl;
+      std::exit(1);
+    }
+
+    for (const JSONValue& benchmark: benchmarks->elements) {
+      const JSONValue* name = benchmark.get("name");
+      const JSONValue* paradigm = benchmark.get("paradigm");
+      const JSONValue* parameters = benchmark.get("parameters");
+      const JSONValue* runs = benchmark.get("runs");
+      if (name == nullptr || paradigm == nullptr || runs == nullptr)
+        continue;
+
+      Result result{name->text, paradigm->text, {}, {}};
+
+      if (parameters != nullptr)
+        for (const auto& parameter: parameters->members)
+          result.parameters.push_back(Parameter{parameter.first, parameter.second.text});
+
+      for (const JSONValue& run: runs->elements) {
+        const JSONValue* cores = run.get("cores");
+        const JSONValue* samples = run.get("samples");
+        if (cores == nullptr || samples == nullptr)
+          continue;
+
+        std::vector<double> values;
+        for (const JSONValue& sample: samples->elements)
+          if (sample.kind == JSONValue::Number)
+            values.push_back(sample.number());
+        result.runs.emplace_back((size_t)cores->number(), values);
+      }
+
+      results.push_back(result);
+    }
+  }
+
+  const Result* find(const std::string& name, const std::string& paradigm) const {
+    for (const Result& result: results)
+      if (result.name == name && result.paradigm == paradigm)
+        return &result;
+    return nullptr;
+  }
+
+  static bool same(const std::vector<Parameter>& a, const std::vector<Parameter>& b) {
+    if (a.size() != b.size())
+      return false;
+    for (size_t i = 0; i < a.size(); i++)
+      if (a[i].name != b[i].name || a[i].value != b[i].value)
+        return false;
+    return true;
+  }
+
+  // Reports how the current samples for one core count compare, counting any
+  // significant slowdown as a regression.
+  void compare(const std::string& name, const std::string& paradigm, const std::vector<Parameter>& parameters, size_t cores, const std::vector<double>& samples) {
+    const Result* baseline = find(name, paradigm);
+    std::cerr << "baseline " << paradigm << " " << name << " (" << cores << " cores): ";
+
+    if (baseline == nullptr) {
+      std::cerr << "not in baseline" << std::endl;
+      return;
+    }
+
+    if (!same(baseline->parameters, parameters)) {
+      std::cerr << "parameters differ, not compared" << std::endl;
+      return;
+    }
+
+    const std::vector<double>* before = nullptr;
+    for (const auto& run: baseline->runs)
+      if (run.first == cores)
+        before = &run.second;
+
+    if (before == nullptr || before->empty() || samples.empty()) {
+      std::cerr << "no baseline samples" << std::endl;
+      return;
+    }
+
+    SampleStats current;
+    SampleStats previous;
+    for (double sample: samples)
+      current.add(sample);
+    for (double sample: *before)
+      previous.add(sample);
+
+    double ratio = current.median() / previous.median();
+    double p = mann_whitney(samples, *before);
+    std::pair<double, double> interval = bootstrap_ratio(samples, *before, 1 - alpha);
+    bool significant = (p < alpha) && ((interval.first > 1) || (interval.second < 1)) &&
+      (std::abs(ratio - 1) * 100 > threshold);
+
+    std::cerr << ratio << "x [" << interval.first << ", " << interval.second << "] p=" << p;
+    if (significant && ratio > 1) {
+      std::cerr << " SLOWER";
+      regressions++;
+    } else if (significant) {
+      std::cerr << " FASTER";
+    }
+    std::cerr << std::endl;
+  }
+};
@@ -3,7 +3,27 @@
 #include <cpp/when.h>
 #include <debug/harness.h>
 #include <float.h>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <tuple>
 #include "stats.h"
+#include "latency.h"
+#include "counters.h"
+#include "cputime.h"
+#include "environment.h"
+#include "registry.h"
+#include "baseline.h"
+#include "placement.h"
+#include "memory.h"
+#include "schedstats.h"
+#include "throughput.h"
+#include "openloop.h"
+#include "validation.h"
+#include "isolate.h"
+#include "sweep.h"
 
 using namespace verona::cpp;
 
@@ -11,8 +31,25 @@ template<class... Ts> struct overloaded : Ts... { using Ts::operator()...; };
 template<class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 
 struct AsyncBenchmark {
+  // Sequential preparation for the next repetition, such as generating input
+  // data. Runs before the clock starts.
+  virtual void setup() {}
   virtual void run()=0;
   virtual std::string paradigm()=0;
+  // True if the benchmark keeps generating work while Throughput::more(), so
+  // that it can be run with --duration.
+  virtual bool continuous() { return false; }
+  // True if the benchmark can serve requests from the --rate driver. run()
+  // then only sets up the server; the driver calls request() for each arrival
+  // while sched.run() is active, and finish() once it has sent the last one.
+  virtual bool open_loop() { return false; }
+  virtual void request(uint64_t intended) {}
+  virtual void finish() {}
+  // With --validate, checks the result of the last run() against a sequential
+  // reference once sched.run() has returned. Returns a description of what is
+  // wrong, or an empty string if the result is correct.
+  virtual bool validates() { return false; }
+  virtual std::string validate() { return ""; }
   virtual ~AsyncBenchmark() {}
 };
 
@@ -29,46 +66,382 @@ struct ActorBenchmark: public AsyncBenchmarkBase {
   std::string paradigm() { return "actor"; }
 };
 
+// One step of a scaling sweep, relative to the smallest core count measured.
+struct ScalingStep {
+  size_t cores;
+  double median;
+  double speedup;
+  double efficiency;
+  // Karp-Flatt estimate of the serial fraction, NaN for the first step.
+  double serial_fraction;
+};
+
 struct Writer {
+  // Names of any optional measurements reported after the timings, the values
+  // are passed to writeEntry in the same order, NaN for any that couldn't be
+  // measured.
+  std::vector<std::string> columns;
+
   virtual void writeHeader()=0;
-  virtual void writeEntry(std::string benchmark, double mean, double median, double error, double stddev)=0;
+  // Called before any samples are written for a benchmark.
+  virtual void writeBenchmark(std::string benchmark, std::string paradigm, const std::vector<Parameter>& parameters, uint64_t seed) {}
+  // The raw per-repetition durations for one core count.
+  virtual void writeSamples(size_t cores, const std::vector<double>& samples) {}
+  // With --duration, the completion rate (operations per second) over each
+  // interval of each repetition for one core count.
+  virtual void writeThroughput(size_t cores, double interval, const std::vector<std::vector<double>>& rates) {}
+  // Called before writeEntry when more than one core count is measured, with
+  // the step for the core count the entry is for.
+  virtual void writeScaling(const ScalingStep& step) {}
+  virtual void writeEntry(std::string benchmark, double mean, double median, double error, double stddev, const std::vector<double>& extra)=0;
   virtual ~Writer() {}
 };
 
 struct CSVWriter: public Writer {
+  // Whether more than one core count is measured, adding the scaling columns.
+  bool scaling;
+  ScalingStep step{};
+
+  CSVWriter(bool scaling = false): scaling(scaling) {}
+
   void writeHeader() override {
-    std::cout << "benchmark,mean,median,error" << std::endl;
+    std::cout << "benchmark,mean,median,error";
+    for (const auto& column: columns)
+      std::cout << "," << column;
+    if (scaling)
+      std::cout << ",cores,speedup,efficiency,serial_fraction";
+    std::cout << std::endl;
+  }
+
+  void writeScaling(const ScalingStep& step) override {
+    this->step = step;
   }
 
-  void writeEntry(std::string benchmark, double mean, double median, double error, double stddev) override {
-    std::cout << benchmark << "," << mean << "," << median << "," << error << std::endl;
+  void writeEntry(std::string benchmark, double mean, double median, double error, double stddev, const std::vector<double>& extra) override {
+    std::cout << benchmark << "," << mean << "," << median << "," << error;
+    // Values that couldn't be measured are left empty, as is the serial
+    // fraction of the first step.
+    for (const double& value: extra) {
+      std::cout << ",";
+      if (!std::isnan(value))
+        std::cout << value;
+    }
+    if (scaling) {
+      std::cout << "," << step.cores << "," << step.speedup << "," << step.efficiency << ",";
+      if (!std::isnan(step.serial_fraction))
+        std::cout << step.serial_fraction;
+    }
+    std::cout << std::endl;
   }
 
   ~CSVWriter() override {}
 };
 
 struct ConsoleWriter: public Writer {
+  std::optional<ScalingStep> step;
+
   void writeHeader() override { }
 
-  void writeEntry(std::string benchmark, double mean, double median, double error, double stddev) override {
+  void writeScaling(const ScalingStep& step) override {
+    this->step = step;
+  }
+
+  void writeEntry(std::string benchmark, double mean, double median, double error, double stddev, const std::vector<double>& extra) override {
     std::cout << benchmark << "   "
               << mean << " ms   "
               << median << " ms   "
               << "+/- " << error << " %   "
-              << stddev
-              << std::endl;
+              << stddev;
+    // Values that couldn't be measured are left out.
+    for (size_t i = 0; i < extra.size(); i++)
+      if (!std::isnan(extra[i]))
+        std::cout << "   " << columns[i] << " " << extra[i];
+    std::cout << std::endl;
+
+    if (step) {
+      std::cout << "  speedup " << step->speedup << "   "
+                << "efficiency " << step->efficiency;
+      if (!std::isnan(step->serial_fraction))
+        std::cout << "   serial " << step->serial_fraction;
+      std::cout << std::endl;
+      step.reset();
+    }
   }
 
   ~ConsoleWriter() override {}
 };
 
+// Writes every raw sample along with the benchmark parameters and a description
+// of the build and machine, for consumption by other tools.
+struct JSONWriter: public Writer {
+  std::ofstream out;
+  std::vector<std::string> arguments;
+  bool first = true;
+
+  std::string paradigm;
+  std::vector<Parameter> parameters;
+  uint64_t seed = 0;
+  std::vector<std::pair<size_t, std::vector<double>>> runs;
+  std::optional<ScalingStep> step;
+  // Interval in ms and per-repetition rates, for each core count.
+  std::vector<std::tuple<size_t, double, std::vector<std::vector<double>>>> throughput;
+
+  JSONWriter(const std::string& filename, std::vector<std::string> arguments): out(filename), arguments(std::move(arguments)) {
+    if (!out)
+      std::cerr << "Could not open " << filename << " for writing" << std::endl;
+    out << std::setprecision(10);
+  }
+
+  // NaN and infinities, such as the IPC of a run that counted no cycles,
+  // have no JSON form and are written as null.
+  struct Number {
+    double value;
+
+    friend std::ostream& operator<<(std::ostream& out, const Number& number) {
+      if (std::isfinite(number.value))
+        return out << number.value;
+      return out << "null";
+    }
+  };
+
+  void writeHeader() override {
+    out << "{\n  \"environment\": {"
+        << "\n    \"flavour\": " << JSONValue::quote(environment::flavour()) << ","
+        << "\n    \"compiler\": " << JSONValue::quote(environment::compiler()) << ","
+        << "\n    \"cpu\": " << JSONValue::quote(environment::cpu_model()) << ","
+        << "\n    \"kernel\": " << JSONValue::quote(environment::kernel()) << ","
+        << "\n    \"arguments\": [";
+    for (size_t i = 0; i < arguments.size(); i++)
+      out << (i == 0 ? "" : ", ") << JSONValue::quote(arguments[i]);
+    out << "]\n  },\n  \"benchmarks\": [";
+  }
+
+  void writeBenchmark(std::string benchmark, std::string paradigm, const std::vector<Parameter>& parameters, uint64_t seed) override {
+    this->paradigm = paradigm;
+    this->parameters = parameters;
+    this->seed = seed;
+    runs.clear();
+    step.reset();
+    throughput.clear();
+  }
+
+  void writeSamples(size_t cores, const std::vector<double>& samples) override {
+    runs.emplace_back(cores, samples);
+  }
+
+  void writeThroughput(size_t cores, double interval, const std::vector<std::vector<double>>& rates) override {
+    throughput.emplace_back(cores, interval, rates);
+  }
+
+  void writeScaling(const ScalingStep& step) override {
+    this->step = step;
+  }
+
+  void writeEntry(std::string benchmark, double mean, double median, double error, double stddev, const std::vector<double>& extra) override {
+    out << (std::exchange(first, false) ? "" : ",")
+        << "\n    {"
+        << "\n      \"name\": " << JSONValue::quote(benchmark) << ","
+        << "\n      \"paradigm\": " << JSONValue::quote(paradigm) << ","
+        << "\n      \"parameters\": {";
+    for (size_t i = 0; i < parameters.size(); i++)
+      out << (i == 0 ? " " : ", ") << JSONValue::quote(parameters[i].name) << ": " << parameters[i].value;
+    out << " },"
+        << "\n      \"seed\": " << seed << ","
+        << "\n      \"mean\": " << Number{mean} << ","
+        << "\n      \"median\": " << Number{median} << ","
+        << "\n      \"error\": " << Number{error} << ","
+        << "\n      \"stddev\": " << Number{stddev} << ",";
+    for (size_t i = 0; i < extra.size(); i++)
+      out << "\n      " << JSONValue::quote(columns[i]) << ": " << Number{extra[i]} << ",";
+    out << "\n      \"runs\": [";
+    for (size_t r = 0; r < runs.size(); r++) {
+      out << (r == 0 ? "" : ",") << "\n        { \"cores\": " << runs[r].first << ", \"samples\": [";
+      for (size_t i = 0; i < runs[r].second.size(); i++)
+        out << (i == 0 ? "" : ", ") << Number{runs[r].second[i]};
+      out << "] }";
+    }
+    out << "\n      ]";
+    if (!throughput.empty()) {
+      out << ",\n      \"throughput\": [";
+      for (size_t t = 0; t < throughput.size(); t++) {
+        out << (t == 0 ? "" : ",")
+            << "\n        { \"cores\": " << std::get<0>(throughput[t])
+            << ", \"interval_ms\": " << std::get<1>(throughput[t])
+            << ", \"rates\": [";
+        const auto& rates = std::get<2>(throughput[t]);
+        for (size_t r = 0; r < rates.size(); r++) {
+          out << (r == 0 ? "[" : ", [");
+          for (size_t i = 0; i < rates[r].size(); i++)
+            out << (i == 0 ? "" : ", ") << Number{rates[r][i]};
+          out << "]";
+        }
+        out << "] }";
+      }
+      out << "\n      ]";
+    }
+    if (step) {
+      out << ",\n      \"scaling\": { \"cores\": " << step->cores
+          << ", \"speedup\": " << Number{step->speedup}
+          << ", \"efficiency\": " << Number{step->efficiency}
+          << ", \"serial_fraction\": " << Number{step->serial_fraction} << " }";
+    }
+    out << "\n    }" << std::flush;
+  }
+
+  ~JSONWriter() override {
+    out << "\n  ]\n}" << std::endl;
+  }
+};
+
+// Durations of the phases of one repetition, in milliseconds.
+struct Repetition {
+  // Scheduler::init(), excluded from the reported time.
+  double init;
+  // benchmark.setup(), excluded from the reported time.
+  double setup;
+  // benchmark.run(), scheduling the initial behaviours before any worker starts.
+  double spawn;
+  // sched.run(), until the runtime is quiescent and has shut down. With
+  // --phases, only until the last stamped() behaviour ended.
+  double parallel;
+  // With --phases, the rest of sched.run(), the runtime shutting down.
+  double shutdown = 0;
+  // With --completion, from the start of spawn until the last
+  // CompletionLatch::signal(), or negative if it was never signalled.
+  double result = -1;
+  // Totals of any --counters over spawn and parallel.
+  std::vector<uint64_t> counters;
+  // With --cpu-time, where the workers' time went during spawn and parallel.
+  CpuTime::Usage cpu;
+  // With --memory, in bytes except for the count of operator new calls. live
+  // is snmalloc's usage once the initial behaviours have been scheduled, and
+  // allocator once the runtime has stopped.
+  uint64_t peak_rss = 0;
+  uint64_t live = 0;
+  uint64_t allocator = 0;
+  uint64_t allocations = 0;
+  uint64_t allocated = 0;
+  // Totals of SchedStats::columns(), in savina-stats with --csv or --json.
+  std::vector<uint64_t> sched;
+  // With --duration, operations per second over each interval.
+  std::vector<double> rates;
+  // With --rate, requests sent by the driver and responses recorded.
+  uint64_t requests = 0;
+  uint64_t responses = 0;
+  // With --validate, what was wrong with the result, if anything.
+  std::string invalid;
+  // 1 if any behaviour was wrapped with stamped(), 0 if none were.
+  uint64_t stamped = 0;
+  // With --latency and --rate, the scheduling delays and response times.
+  LatencyHistogram latency;
+  LatencyHistogram response_times;
+
+  double duration() const { return spawn + parallel + shutdown; }
+
+  // For sending back from an --isolate child, in the same order as decode().
+  std::string encode() const {
+    Isolation::Encoder e;
+    for (double phase: {init, setup, spawn, parallel, shutdown, result})
+      e.put(phase);
+    e.put(counters);
+    e.put(cpu);
+    for (uint64_t value: {peak_rss, live, allocator, allocations, allocated, requests, responses, stamped})
+      e.put(value);
+    e.put(sched);
+    e.put(rates);
+    e.put(invalid);
+    e.put(latency);
+    e.put(response_times);
+    return e.bytes;
+  }
+
+  static Repetition decode(const std::string& bytes) {
+    Isolation::Decoder d(bytes);
+    Repetition r;
+    for (double* phase: {&r.init, &r.setup, &r.spawn, &r.parallel, &r.shutdown, &r.result})
+      d.get(*phase);
+    d.get(r.counters);
+    d.get(r.cpu);
+    for (uint64_t* value: {&r.peak_rss, &r.live, &r.allocator, &r.allocations, &r.allocated, &r.requests, &r.responses, &r.stamped})
+      d.get(*value);
+    d.get(r.sched);
+    d.get(r.rates);
+    d.get(r.invalid);
+    d.get(r.latency);
+    d.get(r.response_times);
+    return r;
+  }
+};
+
+// Does nothing, so that --calibrate can time what a repetition costs on its
+// own: reading the clock, tagging the stats, and starting and stopping the
+// workers. Like any benchmark's, its duration leaves out Scheduler::init().
+struct Calibration: public BocBenchmark {
+  void run() {}
+
+  inline static const std::string name = "Calibration";
+};
+
 struct BenchmarkHarness {
   opt::Opt opt;
 
   size_t cores;
+  // The core counts each benchmark is run with, in increasing order.
+  std::vector<size_t> core_counts;
   size_t repetitions = 1;
+  size_t warmup = 0;
+  // When non-zero, stop repeating once the error is below this percentage.
+  double target_error = 0;
+  size_t min_repetitions = 5;
+  size_t budget = 60;
   bool detect_leaks;
-  std::unique_ptr<Writer> writer;
+  bool sched_latency;
+  // Only the first measured repetition at each core count is traced.
+  bool tracing;
+  bool phases;
+  // --completion, splitting the time into reaching the result and quiescence.
+  bool completion;
+  bool memory_usage;
+  // --alloc-profile, written after each benchmark.
+  std::unique_ptr<std::ofstream> alloc_profile;
+  bool robust;
+  // --calibrate, the durations of Calibration at each core count, measured
+  // the first time a benchmark uses the count.
+  bool calibrate;
+  size_t calibration_reps;
+  std::map<size_t, SampleStats> floors;
+  std::unique_ptr<SchedStats> sched_stats;
+  // --duration, with the rate sampled every interval and the samples in the
+  // first ramp_up ignored for the steady-state rate.
+  milliseconds throughput_duration{0};
+  milliseconds throughput_interval{100};
+  milliseconds throughput_ramp_up{0};
+  std::unique_ptr<Counters> counters;
+  std::unique_ptr<CpuTime> cpu_time;
+  std::unique_ptr<Baseline> baseline;
+  std::unique_ptr<Placement> placement;
+  // --isolate runs each benchmark, or with --isolate-reps each repetition, in
+  // a child process.
+  std::unique_ptr<Isolation> isolation;
+  // --jobs in savina-sys, running each seed in a process of its own.
+  std::unique_ptr<SeedSweep> sweep;
+  // Repetitions that failed --validate or scheduled no stamped() behaviours,
+  // and seeds that failed a --jobs sweep, over all benchmarks.
+  size_t invalid = 0;
+  std::vector<std::string> columns;
+  std::vector<std::unique_ptr<Writer>> writers;
+  // --scale prints each repetition as paradigm,cores,name,ms when there is no
+  // table to report it in.
+  bool scale_lines = false;
+  // Values given with --param name=value, applied to any benchmark with a
+  // parameter of that name.
+  std::vector<Parameter> overrides;
+
+  // The value of a numeric option, exiting with an error if it isn't one.
+  template<typename V>
+  V option(const char* name, const char* fallback) {
+    return parse_parameter<V>(Parameter{name, opt.is(name, fallback)});
+  }
 
   static uint64_t& get_seed() {
     static uint64_t seed = 123456;
@@ -111,6 +484,32 @@ struct BenchmarkHarness {
 
     cores = opt.is<size_t>("--cores", 4);
 
+    // --cores-list 1,2,4,8 sweeps the given core counts, --scale sweeps every
+    // count from 1 to --cores.
+    if (opt.has("--cores-list")) {
+      std::stringstream list(opt.is("--cores-list", ""));
+      std::string count;
+      while (std::getline(list, count, ',')) {
+        if (count.empty())
+          continue;
+        core_counts.push_back(parse_parameter<size_t>(Parameter{"--cores-list", count}));
+        if (core_counts.back() == 0) {
+          std::cerr << "ERROR: --cores-list entries must be at least 1" << std::endl;
+          std::exit(1);
+        }
+      }
+      std::sort(core_counts.begin(), core_counts.end());
+      core_counts.erase(std::unique(core_counts.begin(), core_counts.end()), core_counts.end());
+      if (core_counts.empty()) {
+        std::cerr << "ERROR: --cores-list expects a comma separated list of core counts" << std::endl;
+        std::exit(1);
+      }
+      cores = core_counts.back();
+    } else {
+      for (size_t c = opt.has("--scale") ? 1 : cores; c <= cores; c++)
+        core_counts.push_back(c);
+    }
+
 #ifdef USE_SYSTEMATIC_TESTING
     repetitions = opt.is<size_t>("--seed_count", 1);
     if (opt.has("--reps"))
@@ -118,14 +517,39 @@ struct BenchmarkHarness {
       std::cout << "WARNING: --reps is ignored when using systematic testing" << std::endl;
     }
 
-    if (opt.has("--log-all") || (repetitions == 1))
+    if (opt.has("--warmup") || opt.has("--target-err"))
+    {
+      std::cout << "WARNING: --warmup and --target-err are ignored when using systematic testing" << std::endl;
+    }
+
+    if (opt.has("--jobs")) {
+      size_t jobs = opt.is<size_t>("--jobs", 1);
+      if (jobs == 0) {
+        std::cerr << "ERROR: --jobs must be at least 1" << std::endl;
+        std::exit(1);
+      }
+      sweep = std::make_unique<SeedSweep>(jobs, seconds(opt.is<size_t>("--seed-timeout", 60)), opt.is("--sweep-logs", "."));
+    }
+
+    // A sweep only logs the seed it replays.
+    if ((opt.has("--log-all") || (repetitions == 1)) && !sweep)
       Logging::enable_logging();
 #else
     repetitions = opt.is<size_t>("--reps", 100);
-    if (opt.has("--seed_count"))
+    if (opt.has("--seed_count") || opt.has("--jobs"))
     {
-      std::cout << "WARNING: --seed_count is ignored when not using systematic testing" << std::endl;
+      std::cout << "WARNING: --seed_count and --jobs are ignored when not using systematic testing" << std::endl;
     }
+
+    // Adaptive repetitions: after discarding the warm-up runs, keep repeating
+    // until the error drops below --target-err percent or --budget seconds
+    // have been spent on the benchmark. --reps, if given, is an upper bound.
+    warmup = opt.is<size_t>("--warmup", 0);
+    target_error = option<double>("--target-err", "0");
+    min_repetitions = opt.is<size_t>("--min-reps", 5);
+    budget = opt.is<size_t>("--budget", 60);
+    if (target_error > 0 && !opt.has("--reps"))
+      repetitions = SIZE_MAX;
 #endif
 
     // snmalloc is the default allocator, and libc has some things it doesn't
@@ -134,55 +558,840 @@ struct BenchmarkHarness {
 //    detect_leaks = !opt.has("--allow_leaks");
     Scheduler::set_detect_leaks(detect_leaks);
 
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      std::string setting;
+
+      if (arg == "--param" && (i + 1) < argc)
+        setting = argv[++i];
+      else if (arg.rfind("--param=", 0) == 0)
+        setting = arg.substr(8);
+      else
+        continue;
+
+      size_t equals = setting.find('=');
+      if (equals == std::string::npos) {
+        std::cerr << "ERROR: --param expects name=value, got " << setting << std::endl;
+        std::exit(1);
+      }
+
+      Parameter parameter{setting.substr(0, equals), setting.substr(equals + 1)};
+      bool known = false;
+      for (const RegisteredBenchmark& benchmark: Registry::get())
+        for (const Parameter& p: benchmark.parameters)
+          known |= (p.name == parameter.name);
+
+      if (!known)
+        std::cout << "WARNING: --param " << parameter.name << " does not match any benchmark parameter" << std::endl;
+
+      overrides.push_back(parameter);
+    }
+
+    sched_latency = opt.has("--latency");
+    if (sched_latency) {
+      LatencyRecorder::get().enable();
+      columns.insert(columns.end(), {"sched_p50_us", "sched_p99_us", "sched_p99.9_us", "sched_max_us"});
+    }
+
+    phases = opt.has("--phases");
+    if (phases) {
+      Stamps::timing = true;
+      columns.insert(columns.end(), {"init_ms", "setup_ms", "spawn_ms", "parallel_ms", "shutdown_ms"});
+    }
+
+    completion = opt.has("--completion");
+    if (completion) {
+      CompletionLatch::enabled = true;
+      columns.insert(columns.end(), {"result_ms", "teardown_ms"});
+    }
+
+    memory_usage = opt.has("--memory");
+    if (memory_usage) {
+      std::cerr << "WARNING: --memory counts operator new in allocations and allocated_mb, which leaves out behaviours and cowns, "
+                << "as the runtime allocates them from snmalloc directly; live_mb and allocator_mb include them" << std::endl;
+      columns.insert(columns.end(), {"peak_rss_mb", "live_mb", "allocator_mb", "allocations", "allocated_mb"});
+    }
+
+    if (opt.has("--counters")) {
+      counters = std::make_unique<Counters>(opt.is("--counters", "cycles,instructions,cache-misses,branch-misses,context-switches"));
+      for (const Counters::Counter& counter: counters->counters)
+        columns.push_back(counter.name);
+      if (counters->has("cycles") && counters->has("instructions"))
+        columns.push_back("ipc");
+      // The runtime doesn't count behaviours outside of savina-stats, so
+      // misses are given per thousand instructions.
+      for (const char* misses: {"cache-misses", "branch-misses"})
+        if (counters->has(misses) && counters->has("instructions"))
+          columns.push_back(std::string(misses) + "_pki");
+    }
+
+    // Shares of the workers' capacity (cores times the parallel phase) spent
+    // on a CPU, waiting for one, and parked, with the busiest worker's time
+    // on a CPU over the mean.
+    if (opt.has("--cpu-time")) {
+      cpu_time = std::make_unique<CpuTime>();
+      columns.insert(columns.end(), {"cpu_ms", "utilisation_pct", "run_queue_pct", "parked_pct", "imbalance", "involuntary_switches"});
+    }
+
+    // With --rate, --duration is how long each rate is offered for instead.
+    if (opt.has("--rate")) {
+      OpenLoop::get().enable(opt.is("--rate", ""), opt.is("--arrivals", "poisson"), Throughput::parse("--duration", opt.is("--duration", "1s")));
+      columns.insert(columns.end(), {"offered_per_s", "achieved_per_s", "response_p50_us", "response_p99_us", "response_p99.9_us", "response_max_us"});
+    } else if (opt.has("--duration")) {
+      Throughput::enabled = true;
+      throughput_duration = Throughput::parse("--duration", opt.is("--duration", "10s"));
+      throughput_interval = Throughput::parse("--interval", opt.is("--interval", "100ms"));
+      throughput_ramp_up = opt.has("--ramp-up") ? Throughput::parse("--ramp-up", opt.is("--ramp-up", "0")) : throughput_duration / 5;
+      if (throughput_interval.count() <= 0 || throughput_duration.count() <= 0) {
+        std::cerr << "ERROR: --duration and --interval must be positive" << std::endl;
+        std::exit(1);
+      }
+      columns.insert(columns.end(), {"ops_per_s", "steady_ops_per_s", "steady_cv"});
+    }
+
+    // Results of fixed-duration and open-loop runs depend on how far they got.
+    if (opt.has("--validate")) {
+      if (opt.has("--duration") || opt.has("--rate"))
+        std::cout << "WARNING: --validate is ignored with --duration and --rate" << std::endl;
+      else
+        validation::enabled = true;
+    }
+
+    if (opt.has("--isolate") || opt.has("--isolate-reps"))
+      isolation = std::make_unique<Isolation>(opt.has("--isolate-reps"), [this]() {
+        if (counters)
+          counters->reopen();
+      });
+
+    if (opt.has("--alloc-profile")) {
+      std::string filename = opt.is("--alloc-profile", "alloc-profile.txt");
+      if (isolation) {
+        std::cout << "WARNING: --alloc-profile is ignored with --isolate" << std::endl;
+      } else {
+        alloc_profile = std::make_unique<std::ofstream>(filename);
+        if (!*alloc_profile) {
+          std::cerr << "ERROR: could not open " << filename << " for writing" << std::endl;
+          std::exit(1);
+        }
+      }
+    }
+
+    // The trace is recorded in the child, and it only keeps the repetition.
+    tracing = opt.has("--trace") && !isolation;
+    if (opt.has("--trace") && isolation)
+      std::cout << "WARNING: --trace is ignored with --isolate" << std::endl;
+    if (tracing) {
+      size_t events = option<size_t>("--trace-events", "65536");
+      if (events == 0) {
+        std::cerr << "ERROR: --trace-events must be positive" << std::endl;
+        std::exit(1);
+      }
+      Trace::get().open(opt.is("--trace", "trace.json"), events);
+    }
+
+#ifdef USE_SCHED_STATS
+    // Without --csv or --json the runtime's own statistics rows are left on
+    // stdout, as scripts/produce_table_boc_full.py expects.
+    if (opt.has("--csv") || opt.has("--json")) {
+      sched_stats = std::make_unique<SchedStats>();
+      for (const std::string& column: SchedStats::columns())
+        columns.push_back(column);
+    }
+#endif
+
+    // Distribution-free summaries, for timings that are skewed or have a
+    // few very slow repetitions.
+    robust = opt.has("--robust");
+    if (robust)
+      columns.insert(columns.end(), {"median_ci_low", "median_ci_high", "mad", "outliers"});
+
+    // The overhead is the median duration of Calibration, the noise its
+    // median absolute deviation, and the adjusted figures have the overhead
+    // taken off. A difference within the noise can't be told from none.
+    calibrate = opt.has("--calibrate");
+    calibration_reps = opt.is<size_t>("--calibration-reps", 30);
+    if (calibrate && (Throughput::enabled || OpenLoop::get().enabled)) {
+      std::cout << "WARNING: --calibrate is ignored with --duration and --rate" << std::endl;
+      calibrate = false;
+    }
+    if (calibrate)
+      columns.insert(columns.end(), {"overhead_ms", "noise_ms", "noise_pct", "adjusted_mean", "adjusted_median"});
+
+    if (target_error > 0)
+      columns.push_back("reps");
+
+    // --compare writes its own report instead.
+    bool comparing = opt.has("--compare") || opt.has("--compare-pair");
+
+    // --scale on its own sweeps Banking and prints each repetition instead,
+    // as scripts/produce_graph_banking_scale.py expects.
+    bool banking_scale = opt.has("--scale") && !opt.has("--actor") && !opt.has("--full");
+
 #ifndef USE_SCHED_STATS
-    if (!opt.has("--scale"))
+    if (!banking_scale && !comparing)
     {
-      writer = opt.has("--csv") ? std::unique_ptr<Writer>{std::make_unique<CSVWriter>()} : std::make_unique<ConsoleWriter>();
+      if (opt.has("--csv"))
+        writers.push_back(std::make_unique<CSVWriter>(core_counts.size() > 1));
+      else
+        writers.push_back(std::make_unique<ConsoleWriter>());
+    }
+#else
+    if (opt.has("--csv") && !comparing)
+      writers.push_back(std::make_unique<CSVWriter>(core_counts.size() > 1));
+#endif
+
+    scale_lines = opt.has("--scale") && (banking_scale || writers.empty());
+
+    if (opt.has("--json") && !comparing)
+      writers.push_back(std::make_unique<JSONWriter>(opt.is("--json", "results.json"), std::vector<std::string>(argv, argv + argc)));
+
+    if (opt.has("--pin") || opt.has("--numa"))
+      placement = std::make_unique<Placement>(opt.is("--pin", ""), opt.is("--numa", ""));
+
+    if (opt.has("--baseline"))
+      baseline = std::make_unique<Baseline>(opt.is("--baseline", ""), option<double>("--alpha", "0.05"), option<double>("--threshold", "0"));
+
+    for (auto& writer: writers) {
+      writer->columns = columns;
       writer->writeHeader();
     }
+  }
+
+  // Speedup is measured against the first step. When that isn't a single
+  // core, the available parallelism is taken relative to it, so a sweep of
+  // 4,8,16 reports how well the extra cores beyond 4 are used.
+  static ScalingStep scaling_step(const std::vector<ScalingStep>& previous, size_t cores, double median) {
+    if (previous.empty())
+      return ScalingStep{cores, median, 1, 1, std::nan("")};
+
+    double parallelism = (double)cores / (double)previous.front().cores;
+    double speedup = previous.front().median / median;
+    double serial_fraction = ((1 / speedup) - (1 / parallelism)) / (1 - (1 / parallelism));
+    return ScalingStep{cores, median, speedup, speedup / parallelism, serial_fraction};
+  }
+
+  // Exit status for main, non-zero if --baseline found a regression or a
+  // result failed --validate.
+  int status() {
+    return ((baseline && baseline->regressions > 0) || (invalid > 0)) ? 1 : 0;
+  }
+
+  // The benchmark's parameters with any --param overrides applied.
+  std::vector<Parameter> parameters_of(const RegisteredBenchmark& benchmark) {
+    std::vector<Parameter> parameters = benchmark.parameters;
+
+    for (Parameter& parameter: parameters)
+      for (const Parameter& value: overrides)
+        if (value.name == parameter.name)
+          parameter.value = value.value;
+
+    return parameters;
+  }
+
+  void run(const RegisteredBenchmark& benchmark) {
+    benchmark.run(*this, parameters_of(benchmark));
+  }
+
+  // --compare: repetitions of a and b in pairs, each pair in a random order,
+  // so that drift in the machine affects both alike. Reports the median of the
+  // per-pair ratios a / b with a bootstrap confidence interval, the ratio of
+  // the medians with its own, and the Mann-Whitney p-value.
+  void compare(const RegisteredBenchmark& a, const RegisteredBenchmark& b) {
+    std::string label = a.paradigm + " " + a.name + " / " + b.paradigm + " " + b.name;
+    std::function<Repetition(size_t)> first = a.prepare(*this, parameters_of(a));
+    std::function<Repetition(size_t)> second = b.prepare(*this, parameters_of(b));
+    std::mt19937_64 random(get_seed());
+    size_t failures = 0;
+
+    for (size_t c: core_counts) {
+      high_resolution_clock::time_point deadline = high_resolution_clock::now() + seconds(budget);
+      std::vector<double> first_times;
+      std::vector<double> second_times;
+      SampleStats ratios;
+
+      for (size_t i = 0; i < warmup; ++i) {
+        first(c);
+        second(c);
+      }
+
+      for (size_t i = 0; i < repetitions; ++i) {
+        Repetition x;
+        Repetition y;
+        if (random() & 1) {
+          y = second(c);
+          x = first(c);
+        } else {
+          x = first(c);
+          y = second(c);
+        }
+
+        failures += (x.invalid.empty() ? 0 : 1) + (y.invalid.empty() ? 0 : 1);
+        first_times.push_back(x.duration());
+        second_times.push_back(y.duration());
+        ratios.add(x.duration() / y.duration());
+
+        if ((target_error > 0) && (ratios.size() >= min_repetitions) &&
+            ((ratios.ref_err() < target_error) || (high_resolution_clock::now() > deadline)))
+          break;
+      }
+
+      std::pair<double, double> pair_interval = ratios.bootstrap_median();
+      std::pair<double, double> median_interval = bootstrap_ratio(first_times, second_times);
+      double p = mann_whitney(first_times, second_times);
+      double first_median = SampleStats::quantile_of(first_times, 0.5);
+      double second_median = SampleStats::quantile_of(second_times, 0.5);
+
+      if (opt.has("--csv")) {
+        std::cout << a.paradigm << "," << a.name << "," << b.paradigm << "," << b.name << "," << c << "," << ratios.size() << ","
+                  << first_median << "," << second_median << "," << ratios.median() << "," << pair_interval.first << ","
+                  << pair_interval.second << "," << (first_median / second_median) << "," << median_interval.first << ","
+                  << median_interval.second << "," << p << std::endl;
+      } else {
+        std::cout << label << " at " << c << " cores over " << ratios.size() << " pairs: "
+                  << first_median << " ms / " << second_median << " ms" << std::endl
+                  << "  per-pair ratio " << ratios.median() << " [" << pair_interval.first << ", " << pair_interval.second << "]"
+                  << "   ratio of medians " << (first_median / second_median)
+                  << " [" << median_interval.first << ", " << median_interval.second << "]"
+                  << "   p=" << p << std::endl;
+      }
+    }
+
+    if (failures > 0) {
+      std::cerr << "ERROR: " << label << " failed validation in " << failures << " repetitions" << std::endl;
+      invalid += failures;
+    }
+  }
+
+  // The header for --compare --csv.
+  static void compare_header() {
+    std::cout << "first_paradigm,first,second_paradigm,second,cores,pairs,first_median,second_median,"
+              << "ratio,ratio_low,ratio_high,median_ratio,median_ratio_low,median_ratio_high,p" << std::endl;
+  }
+
+  static double elapsed(high_resolution_clock::time_point from, high_resolution_clock::time_point to) {
+    return (double)(duration_cast<microseconds>(to - from).count()) / 1000;
+  }
+
+  template<typename T>
+  Repetition run_once(T& benchmark, size_t cores) {
+    Scheduler& sched = Scheduler::get();
+    OpenLoop& open_loop = OpenLoop::get();
+
+#ifdef USE_SYSTEMATIC_TESTING
+    Systematic::set_seed(get_seed());
 #endif
+
+    // Before Scheduler::init sets up the workers, so that they inherit it,
+    // and before setup, so that the input data is placed like them.
+    if (placement)
+      placement->apply(cores);
+
+    high_resolution_clock::time_point initialising = high_resolution_clock::now();
+
+    sched.init(cores);
+
+    high_resolution_clock::time_point initialised = high_resolution_clock::now();
+
+    Stamps::reset();
+
+    benchmark.setup();
+
+    high_resolution_clock::time_point prepared = high_resolution_clock::now();
+
+    if (counters)
+      counters->start();
+
+    if (memory_usage) {
+      memory::reset_peak();
+      AllocationCounter::start();
+    }
+
+    if (alloc_profile)
+      AllocationProfile::start();
+
+    // Capturing what the runtime prints is set up before the start, like the
+    // counters, so that redirecting stdout isn't timed.
+    if (sched_stats)
+      sched_stats->begin();
+
+    // The --cpu-time sampler starts here, so that neither starting it nor
+    // scanning the threads is timed, and stops once the end is taken.
+    if (cpu_time)
+      cpu_time->begin();
+
+    high_resolution_clock::time_point start = high_resolution_clock::now();
+
+    SchedulerStats::get_tag() = benchmark.name.c_str();
+
+    if (Throughput::enabled)
+      Throughput::reset();
+
+    if (completion)
+      CompletionLatch::reset();
+
+    benchmark.run();
+
+    high_resolution_clock::time_point spawned = high_resolution_clock::now();
+
+    // Behaviours and cowns come from snmalloc directly, so only its usage
+    // shows what scheduling them up front costs.
+    uint64_t live = 0;
+    if (memory_usage)
+      live = memory::allocator_usage();
+
+    std::vector<double> rates;
+    std::thread sampler;
+    if (Throughput::enabled)
+      sampler = std::thread([&]() {
+        if (cpu_time)
+          cpu_time->ignore();
+        rates = Throughput::sample(throughput_duration, throughput_interval);
+      });
+
+    uint64_t requests = 0;
+    std::thread driver;
+    if (open_loop.enabled) {
+      // Keeps the runtime from becoming quiescent between requests.
+      Scheduler::add_external_event_source();
+      driver = std::thread([&]() {
+        if (cpu_time)
+          cpu_time->ignore();
+        requests = open_loop.drive(benchmark, get_seed());
+        Scheduler::remove_external_event_source();
+      });
+    }
+
+    sched.run();
+
+    high_resolution_clock::time_point end = high_resolution_clock::now();
+
+    CpuTime::Usage cpu;
+    if (cpu_time)
+      cpu = cpu_time->end(cores);
+
+    if (sampler.joinable())
+      sampler.join();
+
+    if (driver.joinable())
+      driver.join();
+
+    if (alloc_profile)
+      AllocationProfile::stop();
+
+    std::vector<uint64_t> sched_counts;
+    if (sched_stats)
+      sched_counts = sched_stats->end(benchmark.name);
+
+    if (placement)
+      placement->restore();
+
+    std::vector<uint64_t> counts;
+    if (counters)
+      counts = counters->stop();
+
+    // Behaviours only run inside sched.run(), so the last of them ended
+    // between spawned and end, unless none were stamped.
+    high_resolution_clock::time_point quiescent = end;
+    if (phases && Stamps::last() != 0)
+      quiescent = std::clamp(high_resolution_clock::time_point(high_resolution_clock::duration(Stamps::last())), spawned, end);
+
+    Repetition repetition{elapsed(initialising, initialised), elapsed(initialised, prepared), elapsed(start, spawned),
+                          elapsed(spawned, quiescent), elapsed(quiescent, end), -1, counts};
+    repetition.sched = sched_counts;
+    repetition.cpu = cpu;
+    repetition.rates = rates;
+    if (completion && CompletionLatch::signalled())
+      repetition.result = elapsed(start, CompletionLatch::at());
+    if (sched_latency) {
+      repetition.latency = LatencyRecorder::get().merge();
+      LatencyRecorder::get().reset();
+    }
+    if (open_loop.enabled) {
+      repetition.requests = requests;
+      repetition.response_times = open_loop.merge();
+      repetition.responses = repetition.response_times.total;
+      open_loop.reset();
+    }
+
+    if (memory_usage) {
+      std::tie(repetition.allocations, repetition.allocated) = AllocationCounter::stop();
+      repetition.peak_rss = memory::status("VmHWM");
+      repetition.live = live;
+      repetition.allocator = memory::allocator_usage();
+    }
+
+    if (validation::enabled && benchmark.validates())
+      repetition.invalid = benchmark.validate();
+
+    repetition.stamped = Stamps::seen.load(std::memory_order_relaxed);
+
+    if (detect_leaks)
+      snmalloc::debug_check_empty<snmalloc::Alloc::Config>();
+
+    return repetition;
+  }
+
+  // The durations of Calibration at `cores`, run the same way as the
+  // benchmarks, including --warmup and --isolate.
+  SampleStats& noise_floor(size_t cores) {
+    auto it = floors.find(cores);
+    if (it != floors.end())
+      return it->second;
+
+    Calibration empty;
+    SampleStats& durations = floors[cores];
+    for (size_t i = 0; i < warmup; ++i)
+      repeat(empty, empty.name, cores);
+    for (size_t i = 0; i < calibration_reps; ++i)
+      durations.add(repeat(empty, empty.name, cores).duration());
+
+    if (isolation)
+      isolation->finish();
+
+    return durations;
+  }
+
+  // One repetition, in a child process with --isolate.
+  template<typename T>
+  Repetition repeat(T& benchmark, const std::string& name, size_t cores) {
+    if (!isolation)
+      return run_once(benchmark, cores);
+
+    return Repetition::decode(isolation->run(name, cores, [&](size_t cores) { return run_once(benchmark, cores).encode(); }));
+  }
+
+  // Every seed of --seed_count, in parallel, continuing from where the last
+  // benchmark left off as the sequential runs do.
+  template<typename T>
+  void sweep_seeds(T& benchmark) {
+    uint64_t first = get_seed();
+    std::vector<SeedSweep::Failure> failures = sweep->run(benchmark.name, first, repetitions,
+      [&](uint64_t seed) {
+        get_seed() = seed;
+        return run_once(benchmark, cores).invalid.empty();
+      },
+      []() { Logging::enable_logging(); });
+
+    get_seed() = first + repetitions;
+    invalid += failures.size();
   }
 
   template<typename T, typename...Args>
   void run(Args&&... args) {
-    SampleStats samples;
+    // Unregistered benchmarks have no parameter names, so use their positions.
+    size_t position = 0;
+    std::vector<Parameter> parameters{Parameter{std::to_string(position++), format_parameter(args)}...};
+    measure<T>(parameters, std::forward<Args>(args)...);
+  }
 
+  template<typename T, typename...Args>
+  void measure(const std::vector<Parameter>& parameters, Args&&... args) {
     T benchmark(std::forward<Args>(args)...);
 
-    size_t min_cores = opt.has("--scale") ? 1 : cores;
-    for (size_t c = min_cores; c <= cores; c++) {
-      for (size_t i = 0; i < repetitions; ++i) {
-        Scheduler& sched = Scheduler::get();
+    if (Throughput::enabled && !benchmark.continuous()) {
+      std::cout << "WARNING: " << benchmark.name << " does not support --duration, skipped" << std::endl;
+      return;
+    }
+
+    if (sweep) {
+      sweep_seeds(benchmark);
+      return;
+    }
+
+    if (!OpenLoop::get().enabled) {
+      measure_entry(benchmark, benchmark.name, parameters);
+      return;
+    }
+
+    if (!benchmark.open_loop()) {
+      std::cout << "WARNING: " << benchmark.name << " does not support --rate, skipped" << std::endl;
+      return;
+    }
+
+    // Each rate is reported as an entry of its own, one point on the
+    // latency-throughput curve.
+    for (uint64_t rate: OpenLoop::get().rates) {
+      OpenLoop::get().rate = rate;
+      measure_entry(benchmark, benchmark.name + " @ " + std::to_string(rate) + "/s", parameters);
+    }
+  }
 
-        sched.init(c);
+  template<typename T>
+  void measure_entry(T& benchmark, const std::string& name, const std::vector<Parameter>& parameters) {
+    if (validation::enabled && !benchmark.validates())
+      std::cout << "WARNING: " << name << " has no result to validate" << std::endl;
 
-        high_resolution_clock::time_point start = high_resolution_clock::now();
+    // Before the allocation profile is reset, so that it only sees the
+    // benchmark.
+    if (calibrate)
+      for (size_t c: core_counts)
+        noise_floor(c);
 
-        SchedulerStats::get_tag() = benchmark.name.c_str();
+    if (alloc_profile)
+      AllocationProfile::reset();
 
-        benchmark.run();
+    // Each core count of a sweep is an entry of its own, so that its
+    // statistics aren't pooled with those of the others.
+    std::vector<ScalingStep> steps;
+    for (size_t c: core_counts)
+      measure_cores(benchmark, core_counts.size() > 1 ? name + " @ " + std::to_string(c) + " cores" : name, parameters, c, steps);
 
-        sched.run();
+    // The next entry, or the next --rate, starts in a fresh child.
+    if (isolation)
+      isolation->finish();
 
-        double duration = (double)(duration_cast<microseconds>((high_resolution_clock::now() - start)).count()) / 1000;
-        samples.add(duration);
+    if (alloc_profile)
+      AllocationProfile::report(*alloc_profile, name, benchmark.paradigm());
+  }
+
+  // One entry: the repetitions of the benchmark with `c` cores. In a sweep,
+  // the entry's step is added to `steps` and passed to the writers with it.
+  template<typename T>
+  void measure_cores(T& benchmark, const std::string& name, const std::vector<Parameter>& parameters, size_t c, std::vector<ScalingStep>& steps) {
+    SampleStats samples;
+    SampleStats init_samples;
+    SampleStats setup_samples;
+    SampleStats spawn_samples;
+    SampleStats parallel_samples;
+    SampleStats shutdown_samples;
+    SampleStats result_samples;
+    SampleStats teardown_samples;
+    size_t unsignalled = 0;
+    SampleStats peak_rss_samples;
+    SampleStats live_samples;
+    SampleStats allocator_samples;
+    SampleStats allocation_samples;
+    SampleStats allocated_samples;
+    std::vector<SampleStats> sched_samples(sched_stats ? SchedStats::columns().size() : 0);
+    std::vector<SampleStats> counter_samples(counters ? counters->counters.size() : 0);
+    SampleStats cpu_samples;
+    SampleStats utilisation_samples;
+    SampleStats run_queue_samples;
+    SampleStats parked_samples;
+    SampleStats imbalance_samples;
+    SampleStats involuntary_samples;
+    SampleStats throughput_samples;
+    SampleStats steady_samples;
+    SampleStats offered_samples;
+    SampleStats achieved_samples;
+    OpenLoop& open_loop = OpenLoop::get();
+    size_t failures = 0;
+    std::string failure;
+    size_t unstamped = 0;
 
-        if (opt.has("--scale"))
-          std::cout << benchmark.paradigm() << "," << c << "," << benchmark.name << ", " << duration << std::endl;
+    for (auto& writer: writers)
+      writer->writeBenchmark(name, benchmark.paradigm(), parameters, get_seed());
 
-        if (detect_leaks)
-          snmalloc::debug_check_empty<snmalloc::Alloc::Config>();
+    LatencyHistogram latency;
+    LatencyHistogram response_times;
+    std::vector<std::vector<double>> core_rates;
+    high_resolution_clock::time_point deadline = high_resolution_clock::now() + seconds(budget);
+
+    // Warm-up runs are discarded, latency histograms included.
+    for (size_t i = 0; i < warmup; ++i)
+      repeat(benchmark, name, c);
+
+    for (size_t i = 0; i < repetitions; ++i) {
+      if (tracing && i == 0)
+        Trace::get().begin();
+      Repetition repetition = repeat(benchmark, name, c);
+      if (tracing && i == 0)
+        Trace::get().end(name, benchmark.paradigm(), c);
+      latency.add(repetition.latency);
+      response_times.add(repetition.response_times);
+      double duration = repetition.duration();
+      samples.add(duration);
+      init_samples.add(repetition.init);
+      setup_samples.add(repetition.setup);
+      spawn_samples.add(repetition.spawn);
+      parallel_samples.add(repetition.parallel);
+      shutdown_samples.add(repetition.shutdown);
+      if (completion) {
+        // Without a signal, all of it counts towards the result.
+        double result = repetition.result;
+        if (result < 0) {
+          unsignalled++;
+          result = duration;
+        }
+        result_samples.add(result);
+        teardown_samples.add(duration - result);
+      }
+      peak_rss_samples.add((double)repetition.peak_rss / (1 << 20));
+      live_samples.add((double)repetition.live / (1 << 20));
+      allocator_samples.add((double)repetition.allocator / (1 << 20));
+      allocation_samples.add((double)repetition.allocations);
+      allocated_samples.add((double)repetition.allocated / (1 << 20));
+      for (size_t k = 0; k < repetition.sched.size(); k++)
+        sched_samples[k].add((double)repetition.sched[k]);
+      for (size_t k = 0; k < repetition.counters.size(); k++)
+        if (repetition.counters[k] != Counters::MISSING)
+          counter_samples[k].add((double)repetition.counters[k]);
+      if (cpu_time) {
+        const CpuTime::Usage& cpu = repetition.cpu;
+        double utilisation = 100 * cpu.running / cpu.capacity;
+        double run_queue = 100 * cpu.waiting / cpu.capacity;
+        cpu_samples.add(cpu.running);
+        utilisation_samples.add(utilisation);
+        run_queue_samples.add(run_queue);
+        parked_samples.add(std::max(0.0, 100 - utilisation - run_queue));
+        // Unknown for runs too short to see every worker.
+        if (cpu.imbalance > 0)
+          imbalance_samples.add(cpu.imbalance);
+        involuntary_samples.add((double)cpu.involuntary);
+      }
+
+      if (!repetition.invalid.empty() && failures++ == 0)
+        failure = repetition.invalid;
+
+      if (!repetition.stamped)
+        unstamped++;
+
+      if (Throughput::enabled) {
+        SampleStats rates;
+        size_t ramp_up = (size_t)(throughput_ramp_up / throughput_interval);
+        for (size_t k = 0; k < repetition.rates.size(); k++) {
+          rates.add(repetition.rates[k]);
+          if (k >= ramp_up)
+            steady_samples.add(repetition.rates[k]);
+        }
+        throughput_samples.add(rates.mean());
+        core_rates.push_back(repetition.rates);
+      }
+
+      if (open_loop.enabled) {
+        offered_samples.add((double)repetition.requests * 1000 / (double)open_loop.length.count());
+        achieved_samples.add((double)repetition.responses * 1000 / duration);
+      }
+
+      if (scale_lines)
+        std::cout << benchmark.paradigm() << "," << c << "," << benchmark.name << ", " << duration << std::endl;
 
 #ifdef USE_SYSTEMATIC_TESTING
-        get_seed()++;
-        printf("Seed: %zu\n", get_seed());
+      get_seed()++;
+      printf("Seed: %zu\n", get_seed());
 #endif
-      }
+
+      if ((target_error > 0) && (samples.size() >= min_repetitions) &&
+          ((samples.ref_err() < target_error) || (high_resolution_clock::now() > deadline)))
+        break;
     }
-    if (opt.has("--scale"))
-      return;
-#ifndef USE_SCHED_STATS 
-    writer->writeEntry(benchmark.name, samples.mean(), samples.median(), samples.ref_err(), samples.stddev());
-#endif
+
+    for (auto& writer: writers)
+      writer->writeSamples(c, samples.samples);
+
+    if (Throughput::enabled)
+      for (auto& writer: writers)
+        writer->writeThroughput(c, (double)throughput_interval.count(), core_rates);
+
+    if (baseline)
+      baseline->compare(name, benchmark.paradigm(), parameters, c, samples.samples);
+
+    if (failures > 0) {
+      std::cerr << "ERROR: " << name << " failed validation in " << failures << " of " << samples.size()
+                << " repetitions: " << failure << std::endl;
+      invalid += failures;
+    }
+
+    // Behaviours not wrapped with stamped() are invisible to --latency,
+    // --trace and --alloc-profile, so a benchmark that has none is a mistake.
+    if (unstamped > 0) {
+      std::cerr << "ERROR: " << name << " scheduled no stamped() behaviours in " << unstamped << " of " << samples.size()
+                << " repetitions, wrap each when() with stamped()" << std::endl;
+      invalid += unstamped;
+    }
+
+    if (unsignalled > 0)
+      std::cout << "WARNING: " << name << " did not signal its completion in " << unsignalled << " of " << samples.size()
+                << " repetitions, so result_ms is its whole duration" << std::endl;
+
+    std::vector<double> extra;
+
+    // Only behaviours wrapped with stamped() are recorded, and zeros would
+    // read as measurements, so a benchmark without any has no values.
+    if (sched_latency && latency.total == 0) {
+      std::cout << "WARNING: --latency recorded no behaviours for " << name << ", only those wrapped with stamped() are measured" << std::endl;
+      extra.insert(extra.end(), 4, std::nan(""));
+    } else if (sched_latency) {
+      for (double q: {0.5, 0.99, 0.999})
+        extra.push_back((double)latency.percentile(q) / 1000);
+      extra.push_back((double)latency.max / 1000);
+    }
+
+    if (phases)
+      extra.insert(extra.end(), {init_samples.mean(), setup_samples.mean(), spawn_samples.mean(), parallel_samples.mean(),
+                                 shutdown_samples.mean()});
+
+    if (completion)
+      extra.insert(extra.end(), {result_samples.mean(), teardown_samples.mean()});
+
+    if (memory_usage)
+      extra.insert(extra.end(), {peak_rss_samples.mean(), live_samples.mean(), allocator_samples.mean(), allocation_samples.mean(),
+                                 allocated_samples.mean()});
+
+    // A counter that was never read has no values, nor has anything derived
+    // from it.
+    if (counters) {
+      auto total = [&](const std::string& name) {
+        for (size_t k = 0; k < counter_samples.size(); k++)
+          if (counters->counters[k].name == name && counter_samples[k].size() > 0)
+            return counter_samples[k].sum();
+        return std::nan("");
+      };
+
+      for (SampleStats& counter: counter_samples)
+        extra.push_back(counter.size() > 0 ? counter.mean() : std::nan(""));
+      if (counters->has("cycles") && counters->has("instructions"))
+        extra.push_back(total("instructions") / total("cycles"));
+      for (const char* misses: {"cache-misses", "branch-misses"})
+        if (counters->has(misses) && counters->has("instructions"))
+          extra.push_back(1000 * total(misses) / total("instructions"));
+    }
+
+    if (cpu_time)
+      extra.insert(extra.end(), {cpu_samples.mean(), utilisation_samples.mean(), run_queue_samples.mean(), parked_samples.mean(),
+                                 imbalance_samples.size() > 0 ? imbalance_samples.mean() : 0, involuntary_samples.mean()});
+
+    if (Throughput::enabled)
+      extra.insert(extra.end(), {throughput_samples.mean(), steady_samples.mean(), steady_samples.variation()});
+
+    if (open_loop.enabled) {
+      extra.insert(extra.end(), {offered_samples.mean(), achieved_samples.mean()});
+      for (double q: {0.5, 0.99, 0.999})
+        extra.push_back((double)response_times.percentile(q) / 1000);
+      extra.push_back((double)response_times.max / 1000);
+    }
+
+    if (sched_stats) {
+      if (sched_samples.empty() || sched_samples[0].size() == 0)
+        std::cerr << "WARNING: the runtime printed no scheduler statistics for " << name << std::endl;
+      for (SampleStats& stat: sched_samples)
+        extra.push_back(stat.size() == 0 ? 0 : stat.mean());
+    }
+
+    if (robust) {
+      std::pair<double, double> interval = samples.bootstrap_median();
+      extra.insert(extra.end(), {interval.first, interval.second, samples.mad(), (double)samples.outliers()});
+    }
+
+    // Calibration is measured once for each core count, before the first
+    // entry that uses it, so its figures are the same for every entry.
+    if (calibrate) {
+      double overhead = floors[c].median();
+      double noise = floors[c].mad();
+      extra.insert(extra.end(), {overhead, noise, 100 * noise / samples.median(),
+                                 samples.mean() - overhead, samples.median() - overhead});
+    }
+
+    if (target_error > 0)
+      extra.push_back((double)samples.size());
+
+    if (core_counts.size() > 1) {
+      steps.push_back(scaling_step(steps, c, samples.median()));
+      for (auto& writer: writers)
+        writer->writeScaling(steps.back());
+    }
+
+    for (auto& writer: writers)
+      writer->writeEntry(name, samples.mean(), samples.median(), samples.ref_err(), samples.stddev(), extra);
   }
 };
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+// The logical end of a benchmark, reported with --completion.
+//
+// sched.run() only returns once the runtime is quiescent, which includes
+// releasing every cown and running any clean-up behaviours after the answer is
+// known. A benchmark calls CompletionLatch::signal() from the behaviour that
+// completes its result, and the harness reports the time to that point
+// (result_ms) separately from the rest (teardown_ms). The completions handed
+// out by validation::Result signal it, so any benchmark that can be validated
+// already marks its end; others call it where they finish:
+//
+//   if (--self->remaining == 0)
+//     CompletionLatch::signal();
+//
+// If it is signalled more than once, the last one counts.
+struct CompletionLatch {
+  inline static std::atomic<bool> enabled{false};
+  // high_resolution_clock ticks since its epoch, 0 until signalled.
+  inline static std::atomic<std::chrono::high_resolution_clock::rep> reached{0};
+
+  static void signal() {
+    if (enabled.load(std::memory_order_relaxed))
+      reached.store(std::chrono::high_resolution_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+  }
+
+  static void reset() {
+    reached.store(0, std::memory_order_relaxed);
+  }
+
+  static bool signalled() {
+    return reached.load(std::memory_order_relaxed) != 0;
+  }
+
+  // Only call once the scheduler has stopped.
+  static std::chrono::high_resolution_clock::time_point at() {
+    return std::chrono::high_resolution_clock::time_point(
+      std::chrono::high_resolution_clock::duration(reached.load(std::memory_order_relaxed)));
+  }
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <string>
+#include <utility>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+// Hardware and software performance counters, selected with
+// --counters cycles,instructions,...
+//
+// The counters are opened on the main thread with inherit set before the
+// scheduler starts its workers, so the worker threads get their own copies and
+// their counts are added back when they exit at the end of sched.run().
+//
+// When more counters are asked for than the PMU has, the kernel multiplexes
+// them and each only counts for part of the time. Its count is then scaled up
+// by the time it was enabled over the time it was running, with a warning, as
+// perf stat does.
+struct Counters {
+  // In place of the count of a counter that could not be read.
+  static constexpr uint64_t MISSING = UINT64_MAX;
+
+  struct Event {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+  };
+
+  struct Counter {
+    std::string name;
+    int fd;
+  };
+
+  static const std::vector<Event>& events() {
+    static const std::vector<Event> known = {
+      {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {"cache-references", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+      {"cache-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+      {"branches", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+      {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+      {"task-clock", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+      {"context-switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+      {"cpu-migrations", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS},
+      {"page-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    };
+    return known;
+  }
+
+  std::vector<Counter> counters;
+  bool warned_missing = false;
+  bool warned_multiplexed = false;
+
+  // Opens each of the comma separated events, warning about and skipping any
+  // that the kernel refuses (e.g. because of perf_event_paranoid).
+  Counters(const std::string& list) {
+    size_t start = 0;
+    while (start <= list.size()) {
+      size_t end = list.find(',', start);
+      if (end == std::string::npos)
+        end = list.size();
+
+      std::string name = list.substr(start, end - start);
+      start = end + 1;
+      if (name.empty())
+        continue;
+
+      const Event* event = nullptr;
+      for (const Event& e: events())
+        if (name == e.name)
+          event = &e;
+
+      if (event == nullptr) {
+        std::cerr << "ERROR: unknown counter " << name << ", expected one of:";
+        for (const Event& e: events())
+          std::cerr << " " << e.name;
+        std::cerr << std::endl;
+        std::exit(1);
+      }
+
+      int fd = open(*event);
+      if (fd < 0) {
+        std::cout << "WARNING: could not open counter " << name << ": " << std::strerror(errno) << std::endl;
+        continue;
+      }
+
+      counters.push_back(Counter{name, fd});
+    }
+  }
+
+  // Opens the same events again for the calling process, e.g. in a child
+  // forked by --isolate, whose counts the inherited descriptors don't include.
+  // A counter that can't be opened again is dropped, and its count reported
+  // as MISSING so that the others keep their columns.
+  void reopen() {
+    for (Counter& counter: counters) {
+      close(counter.fd);
+      for (const Event& e: events())
+        if (counter.name == e.name)
+          counter.fd = open(e);
+      if (counter.fd < 0)
+        std::cout << "WARNING: could not reopen counter " << counter.name << ": " << std::strerror(errno) << ", dropped" << std::endl;
+    }
+  }
+
+  Counters(const Counters&) = delete;
+  Counters& operator=(const Counters&) = delete;
+
+  ~Counters() {
+    for (const Counter& counter: counters)
+      if (counter.fd >= 0)
+        close(counter.fd);
+  }
+
+  static int open(const Event& event, bool exclude_kernel) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = exclude_kernel;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+
+  // Software events such as context switches only happen in the kernel, so
+  // count kernel time for them if we are allowed to.
+  static int open(const Event& event) {
+    int fd = -1;
+    if (event.type == PERF_TYPE_SOFTWARE)
+      fd = open(event, false);
+    if (fd < 0)
+      fd = open(event, true);
+    return fd;
+  }
+
+  bool has(const std::string& name) const {
+    for (const Counter& counter: counters)
+      if (counter.name == name)
+        return true;
+    return false;
+  }
+
+  void start() {
+    for (const Counter& counter: counters) {
+      if (counter.fd < 0)
+        continue;
+      ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  // Totals since start(), in the order the counters were given, scaled up
+  // for any time they were multiplexed out. MISSING for a counter that was
+  // dropped, couldn't be read, or never got onto the PMU.
+  std::vector<uint64_t> stop() {
+    std::vector<uint64_t> values;
+
+    for (const Counter& counter: counters) {
+      if (counter.fd < 0) {
+        values.push_back(MISSING);
+        continue;
+      }
+
+      ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+
+      // As laid out by PERF_FORMAT_TOTAL_TIME_ENABLED and _RUNNING.
+      struct {
+        uint64_t value;
+        uint64_t enabled;
+        uint64_t running;
+      } reading{};
+
+      if (read(counter.fd, &reading, sizeof(reading)) != sizeof(reading) || (reading.running == 0 && reading.enabled > 0)) {
+        if (!std::exchange(warned_missing, true))
+          std::cout << "WARNING: could not read counter " << counter.name << ", its count is left out" << std::endl;
+        values.push_back(MISSING);
+        continue;
+      }
+
+      if (reading.running < reading.enabled) {
+        if (!std::exchange(warned_multiplexed, true))
+          std::cout << "WARNING: counter " << counter.name << " was multiplexed and only ran for "
+                    << (100 * reading.running / reading.enabled) << "% of the time, counts are scaled" << std::endl;
+        reading.value = (uint64_t)((double)reading.value * (double)reading.enabled / (double)reading.running);
+      }
+
+      values.push_back(reading.value);
+    }
+
+    return values;
+  }
+};
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+// Where the workers' time goes, selected with --cpu-time.
+//
+// The workers only exist inside sched.run(), so from before the benchmark is
+// started a thread polls /proc/self/task/<tid>/schedstat for every thread that
+// wasn't there before, and that the harness didn't start itself,
+// which gives each worker's time on a CPU and time waiting for one, in
+// nanoseconds. Anything a worker does after the last poll is missed, so the
+// total comes from the process CPU clock instead, which also counts threads
+// that have exited, less the threads that aren't workers.
+//
+// Spinning for work counts as time on a CPU like running behaviours does, so
+// a benchmark that is serial but keeps the other workers spinning shows as
+// high utilisation without a speedup, and one that lets them park as low
+// utilisation.
+struct CpuTime {
+  // What is read from a thread's schedstat.
+  struct Task {
+    uint64_t running = 0;
+    uint64_t waiting = 0;
+  };
+
+  // Totals over the workers for one sched.run(), in milliseconds.
+  struct Usage {
+    // On a CPU, waiting on a run queue, and the capacity of cores workers
+    // over the run, of which the rest is parked.
+    double running = 0;
+    double waiting = 0;
+    double capacity = 0;
+    // The busiest worker's time on a CPU relative to the mean, 1 if even, or
+    // 0 if the run was too short for every worker to be polled.
+    double imbalance = 0;
+    uint64_t involuntary = 0;
+  };
+
+  static constexpr std::chrono::milliseconds INTERVAL{10};
+
+  // Threads that were there before begin(), and what they had used, and those
+  // the harness started since.
+  std::map<pid_t, Task> existing;
+  std::map<pid_t, Task> workers;
+  std::mutex threads;
+  // So that end() doesn't wait out the rest of an interval.
+  std::mutex mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+  std::atomic<pid_t> sampler_tid{0};
+  // The sampler's own time on a CPU, taken off the total.
+  uint64_t sampler_running = 0;
+  std::thread sampler;
+  uint64_t process_start = 0;
+  long involuntary_start = 0;
+  std::chrono::steady_clock::time_point started;
+
+  CpuTime() {
+    Task task;
+    if (!read(gettid(), task)) {
+      std::cerr << "ERROR: --cpu-time needs /proc/self/task/<tid>/schedstat, which this kernel doesn't provide" << std::endl;
+      std::exit(1);
+    }
+  }
+
+  static pid_t gettid() { return (pid_t)syscall(SYS_gettid); }
+
+  static uint64_t clock(clockid_t id) {
+    timespec now;
+    clock_gettime(id, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+  }
+
+  static long involuntary() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nivcsw;
+  }
+
+  static bool read(pid_t tid, Task& task) {
+    std::ifstream file("/proc/self/task/" + std::to_string(tid) + "/schedstat");
+    return (bool)(file >> task.running >> task.waiting);
+  }
+
+  template<typename F>
+  static void each_thread(F f) {
+    DIR* tasks = opendir("/proc/self/task");
+    if (tasks == nullptr)
+      return;
+
+    while (dirent* entry = readdir(tasks))
+      if (entry->d_name[0] != '.')
+        f((pid_t)std::atoi(entry->d_name));
+
+    closedir(tasks);
+  }
+
+  // Before the benchmark schedules anything, so that none of this is timed.
+  void begin() {
+    existing.clear();
+    workers.clear();
+    each_thread([&](pid_t tid) {
+      Task task;
+      if (read(tid, task))
+        existing[tid] = task;
+    });
+
+    involuntary_start = involuntary();
+    process_start = clock(CLOCK_PROCESS_CPUTIME_ID);
+    started = std::chrono::steady_clock::now();
+
+    stopping = false;
+    sampler_tid.store(0, std::memory_order_relaxed);
+    sampler = std::thread([this]() {
+      sampler_tid.store(gettid(), std::memory_order_relaxed);
+      std::unique_lock<std::mutex> lock(mutex);
+      while (!stopping) {
+        lock.unlock();
+        poll();
+        lock.lock();
+        wake.wait_for(lock, INTERVAL, [this]() { return stopping; });
+      }
+      sampler_running = clock(CLOCK_THREAD_CPUTIME_ID);
+    });
+  }
+
+  // On a thread the harness starts after begin(), such as the --duration
+  // sampler or the --rate driver, so that it isn't taken for a worker.
+  void ignore() {
+    std::lock_guard<std::mutex> lock(threads);
+    pid_t tid = gettid();
+    workers.erase(tid);
+    existing[tid] = Task{};
+  }
+
+  // On the sampler, the latest figures of every thread that is new.
+  void poll() {
+    pid_t self = sampler_tid.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(threads);
+    each_thread([&](pid_t tid) {
+      Task task;
+      if (tid != self && existing.find(tid) == existing.end() && read(tid, task))
+        workers[tid] = task;
+    });
+  }
+
+  // After sched.run(), with the number of workers it was initialised with.
+  Usage end(size_t cores) {
+    uint64_t process = clock(CLOCK_PROCESS_CPUTIME_ID) - process_start;
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_one();
+    sampler.join();
+
+    std::lock_guard<std::mutex> lock(threads);
+    Usage usage;
+    usage.involuntary = (uint64_t)(involuntary() - involuntary_start);
+    usage.capacity = elapsed * (double)cores;
+
+    // The runtime may run a worker on the calling thread, which otherwise
+    // just waits for the others, so it counts as a worker if it was on a CPU
+    // for most of the run.
+    pid_t main = gettid();
+    uint64_t others = sampler_running;
+    for (const auto& thread: existing) {
+      Task now;
+      if (!read(thread.first, now))
+        continue;
+
+      Task used{now.running - thread.second.running, now.waiting - thread.second.waiting};
+      if (thread.first == main && (double)used.running > elapsed * 1e6 / 2)
+        workers[main] = used;
+      else
+        others += used.running;
+    }
+
+    usage.running = (double)(process > others ? process - others : 0) / 1e6;
+
+    uint64_t busiest = 0;
+    uint64_t sampled = 0;
+    for (const auto& worker: workers) {
+      busiest = std::max(busiest, worker.second.running);
+      sampled += worker.second.running;
+      usage.waiting += (double)worker.second.waiting / 1e6;
+    }
+
+    if (sampled > 0 && workers.size() >= cores)
+      usage.imbalance = (double)busiest * (double)workers.size() / (double)sampled;
+
+    return usage;
+  }
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <sys/utsname.h>
+
+// Describes the build and machine a result was produced on, so that results
+// from different runs can be told apart.
+namespace environment {
+  inline std::string flavour() {
+#if defined(USE_SCHED_STATS)
+    return "savina-stats";
+#elif defined(USE_SYSTEMATIC_TESTING)
+    return "savina-sys";
+#else
+    return "savina";
+#endif
+  }
+
+  inline std::string compiler() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#else
+    return "unknown";
+#endif
+  }
+
+  inline std::string cpu_model() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+
+    while (std::getline(cpuinfo, line)) {
+      if (line.rfind("model name", 0) == 0) {
+        size_t start = line.find_first_not_of(" \t:", line.find(':'));
+        if (start != std::string::npos)
+          return line.substr(start);
+      }
+    }
+
+    return "unknown";
+  }
+
+  inline std::string kernel() {
+    struct utsname name;
+    if (uname(&name) != 0)
+      return "unknown";
+
+    return std::string(name.sysname) + " " + name.release;
+  }
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+// Process isolation, selected with --isolate.
+//
+// Allocator state, fragmentation and the page cache otherwise carry over from
+// one benchmark to the next in the same process, so results can depend on what
+// ran before. With --isolate, the parent never runs the scheduler itself: it
+// forks a child for each benchmark, asks it for one repetition at a time over
+// a pipe, and the child sends each back encoded as bytes. With --isolate-reps,
+// every repetition gets a child of its own.
+//
+// The parent carries on aggregating and writing results exactly as before, so
+// the only difference in the output is the absence of state from earlier runs.
+struct Isolation {
+  // Builds up the bytes of a message sent back to the parent.
+  struct Encoder {
+    std::string bytes;
+
+    template<typename T>
+    void put(const T& value) {
+      static_assert(std::is_trivially_copyable_v<T>);
+      bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    void put(const std::vector<T>& values) {
+      put((uint64_t)values.size());
+      for (const T& value: values)
+        put(value);
+    }
+
+    void put(const std::string& value) {
+      put((uint64_t)value.size());
+      bytes.append(value);
+    }
+  };
+
+  // Reads the values back in the order they were put.
+  struct Decoder {
+    const std::string& bytes;
+    size_t offset = 0;
+
+    Decoder(const std::string& bytes): bytes(bytes) {}
+
+    template<typename T>
+    void get(T& value) {
+      static_assert(std::is_trivially_copyable_v<T>);
+      std::memcpy(&value, bytes.data() + offset, sizeof(T));
+      offset += sizeof(T);
+    }
+
+    template<typename T>
+    void get(std::vector<T>& values) {
+      uint64_t size = 0;
+      get(size);
+      values.resize(size);
+      for (T& value: values)
+        get(value);
+    }
+
+    void get(std::string& value) {
+      uint64_t size = 0;
+      get(size);
+      value = bytes.substr(offset, size);
+      offset += size;
+    }
+  };
+
+  bool per_repetition;
+  // Called in each child after it is forked, e.g. to reopen per-process state.
+  std::function<void()> on_fork;
+  pid_t child = -1;
+  // Core counts from the parent to the child, results from the child back.
+  int requests = -1;
+  int results = -1;
+
+  Isolation(bool per_repetition, std::function<void()> on_fork): per_repetition(per_repetition), on_fork(std::move(on_fork)) {}
+
+  Isolation(const Isolation&) = delete;
+  Isolation& operator=(const Isolation&) = delete;
+
+  ~Isolation() { finish(); }
+
+  // Runs `repeat` with the given core count in the current child, forking one
+  // if there isn't one, and returns what it encoded.
+  std::string run(const std::string& name, size_t cores, const std::function<std::string(size_t)>& repeat) {
+    if (child < 0)
+      spawn(repeat);
+
+    uint64_t request = cores;
+    std::string result;
+    uint64_t size = 0;
+    bool ok = write_all(requests, &request, sizeof(request)) && read_all(results, &size, sizeof(size));
+    if (ok) {
+      result.resize(size);
+      ok = read_all(results, result.data(), size);
+    }
+
+    if (!ok) {
+      int status = finish();
+      std::cerr << "ERROR: the isolated process running " << name << " died";
+      if (WIFSIGNALED(status))
+        std::cerr << " with signal " << WTERMSIG(status);
+      else if (WIFEXITED(status))
+        std::cerr << " with status " << WEXITSTATUS(status);
+      std::cerr << std::endl;
+      std::exit(1);
+    }
+
+    if (per_repetition)
+      finish();
+
+    return result;
+  }
+
+  // Lets the current child exit and waits for it, returning its wait status.
+  int finish() {
+    if (child < 0)
+      return 0;
+
+    close(requests);
+    close(results);
+
+    int status = 0;
+    while (waitpid(child, &status, 0) < 0 && errno == EINTR) {}
+    child = -1;
+    return status;
+  }
+
+  void spawn(const std::function<std::string(size_t)>& repeat) {
+    int down[2];
+    int up[2];
+    if (pipe(down) != 0 || pipe(up) != 0) {
+      std::cerr << "ERROR: --isolate could not create a pipe: " << std::strerror(errno) << std::endl;
+      std::exit(1);
+    }
+
+    // A child that dies shouldn't take the parent with it on the next request.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // Anything still buffered would otherwise be written by both processes.
+    std::cout << std::flush;
+    std::cerr << std::flush;
+
+    child = fork();
+    if (child < 0) {
+      std::cerr << "ERROR: --isolate could not fork: " << std::strerror(errno) << std::endl;
+      std::exit(1);
+    }
+
+    if (child == 0) {
+      close(down[1]);
+      close(up[0]);
+      serve(down[0], up[1], repeat);
+    }
+
+    close(down[0]);
+    close(up[1]);
+    requests = down[1];
+    results = up[0];
+  }
+
+  // The child's loop, until the parent closes its end of the pipe. Exits with
+  // _exit so that the parent's writers aren't flushed a second time.
+  [[noreturn]] void serve(int in, int out, const std::function<std::string(size_t)>& repeat) {
+    if (on_fork)
+      on_fork();
+
+    uint64_t cores = 0;
+    while (read_all(in, &cores, sizeof(cores))) {
+      std::string result = repeat(cores);
+      std::cout << std::flush;
+
+      uint64_t size = result.size();
+      if (!write_all(out, &size, sizeof(size)) || !write_all(out, result.data(), size))
+        _exit(1);
+    }
+
+    _exit(0);
+  }
+
+  static bool write_all(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+      ssize_t written = write(fd, bytes, size);
+      if (written < 0 && errno == EINTR)
+        continue;
+      if (written <= 0)
+        return false;
+      bytes += written;
+      size -= (size_t)written;
+    }
+    return true;
+  }
+
+  static bool read_all(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+      ssize_t got = read(fd, bytes, size);
+      if (got < 0 && errno == EINTR)
+        continue;
+      if (got <= 0)
+        return false;
+      bytes += got;
+      size -= (size_t)got;
+    }
+    return true;
+  }
+};
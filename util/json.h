@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cctype>
+#include <string>
+#include <vector>
+
+// Just enough of a JSON reader to load the files written by JSONWriter.
+//
+// Scalars keep their text, so numbers read back exactly as they were written
+// and parameter values compare equal to the formatted defaults.
+struct JSONValue {
+  enum Kind { Null, Bool, Number, String, Array, Object };
+
+  Kind kind = Null;
+  std::string text;
+  std::vector<JSONValue> elements;
+  std::vector<std::pair<std::string, JSONValue>> members;
+
+  const JSONValue* get(const std::string& name) const {
+    for (const auto& member: members)
+      if (member.first == name)
+        return &member.second;
+    return nullptr;
+  }
+
+  double number() const { return std::stod(text); }
+
+  // value as a JSON string, as JSONWriter and --trace write them.
+  static std::string quote(const std::string& value) {
+    std::string result = "\"";
+    for (char c: value) {
+      if (c == '"' || c == '\\')
+        result += '\\';
+      if ((unsigned char)c < 0x20)
+        result += ' ';
+      else
+        result += c;
+    }
+    return result + "\"";
+  }
+
+  // Returns false, leaving result partially filled, if the text isn't valid.
+  static bool parse(const std::string& input, JSONValue& result) {
+    size_t pos = 0;
+    return parse_value(input, pos, result) && (skip(input, pos), pos == input.size());
+  }
+
+private:
+  static void skip(const std::string& in, size_t& pos) {
+    while (pos < in.size() && std::isspace((unsigned char)in[pos]))
+      pos++;
+  }
+
+  static bool parse_string(const std::string& in, size_t& pos, std::string& out) {
+    if (in[pos++] != '"')
+      return false;
+
+    while (pos < in.size() && in[pos] != '"') {
+      if (in[pos] == '\\') {
+        if (++pos == in.size())
+          return false;
+        switch (in[pos]) {
+          case 'n': out += '\n'; break;
+          case 't': out += '\t'; break;
+          case 'r': out += '\r'; break;
+          case 'b': out += '\b'; break;
+          case 'f': out += '\f'; break;
+          case 'u': out += '?'; pos += 4; break;
+          default: out += in[pos]; break;
+        }
+        pos++;
+      } else {
+        out += in[pos++];
+      }
+    }
+
+    return pos++ < in.size();
+  }
+
+  static bool parse_value(const std::string& in, size_t& pos, JSONValue& value) {
+    skip(in, pos);
+    if (pos == in.size())
+      return false;
+
+    char c = in[pos];
+    if (c == '{') {
+      value.kind = Object;
+      pos++;
+      skip(in, pos);
+      if (pos < in.size() && in[pos] == '}')
+        return ++pos, true;
+
+      while (true) {
+        std::string name;
+        skip(in, pos);
+        if (pos == in.size() || !parse_string(in, pos, name))
+          return false;
+        skip(in, pos);
+        if (pos == in.size() || in[pos++] != ':')
+          return false;
+        value.members.emplace_back(name, JSONValue());
+        if (!parse_value(in, pos, value.members.back().second))
+          return false;
+        skip(in, pos);
+        if (pos == in.size())
+          return false;
+        if (in[pos] == '}')
+          return ++pos, true;
+        if (in[pos++] != ',')
+          return false;
+      }
+    }
+
+    if (c == '[') {
+      value.kind = Array;
+      pos++;
+      skip(in, pos);
+      if (pos < in.size() && in[pos] == ']')
+        return ++pos, true;
+
+      while (true) {
+        value.elements.emplace_back();
+        if (!parse_value(in, pos, value.elements.back()))
+          return false;
+        skip(in, pos);
+        if (pos == in.size())
+          return false;
+        if (in[pos] == ']')
+          return ++pos, true;
+        if (in[pos++] != ',')
+          return false;
+      }
+    }
+
+    if (c == '"') {
+      value.kind = String;
+      return parse_string(in, pos, value.text);
+    }
+
+    size_t start = pos;
+    while (pos < in.size() && (std::isalnum((unsigned char)in[pos]) || in[pos] == '-' || in[pos] == '+' || in[pos] == '.'))
+      pos++;
+    value.text = in.substr(start, pos - start);
+
+    if (value.text == "null")
+      value.kind = Null;
+    else if (value.text == "true" || value.text == "false")
+      value.kind = Bool;
+    else if (!value.text.empty() && (std::isdigit((unsigned char)c) || c == '-'))
+      value.kind = Number;
+    else
+      return false;
+
+    return true;
+  }
+};
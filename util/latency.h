@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <typeinfo>
+#include "allocations.h"
+#include "trace.h"
+
+// Log-bucketed (HDR-style) histogram of nanosecond latencies.
+//
+// Values below SUB_BUCKETS are recorded exactly, above that each power of two
+// is split into SUB_BUCKETS linear buckets, so every recorded value is within
+// 1/SUB_BUCKETS (~3%) of its bucket. The memory used is fixed regardless of how
+// many values are recorded.
+struct LatencyHistogram {
+  static constexpr size_t SUB_BITS = 5;
+  static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BITS;
+  static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+  uint64_t counts[BUCKETS] = {};
+  uint64_t total = 0;
+  uint64_t max = 0;
+
+  static size_t index(uint64_t value) {
+    if (value < SUB_BUCKETS)
+      return value;
+
+    size_t group = (63 - __builtin_clzll(value)) - SUB_BITS + 1;
+    return (group * SUB_BUCKETS) + ((value >> (group - 1)) - SUB_BUCKETS);
+  }
+
+  // Largest value that maps to the bucket at index.
+  static uint64_t highest(size_t index) {
+    size_t group = index / SUB_BUCKETS;
+    uint64_t sub = index % SUB_BUCKETS;
+
+    if (group == 0)
+      return sub;
+
+    return ((sub + SUB_BUCKETS + 1) << (group - 1)) - 1;
+  }
+
+  void add(uint64_t value) {
+    counts[index(value)]++;
+    total++;
+    if (value > max)
+      max = value;
+  }
+
+  void add(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKETS; i++)
+      counts[i] += other.counts[i];
+    total += other.total;
+    max = std::max(max, other.max);
+  }
+
+  // q in [0, 1]
+  uint64_t percentile(double q) {
+    if (total == 0)
+      return 0;
+
+    uint64_t rank = (uint64_t)(q * (double)total);
+    if (rank >= total)
+      rank = total - 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+      seen += counts[i];
+      if (seen > rank)
+        return std::min(highest(i), max);
+    }
+
+    return max;
+  }
+};
+
+// Records the time between a behaviour being scheduled with `when` and it
+// starting to run. Each thread records into its own slot without locking, and
+// the slots are merged into a single histogram once the scheduler has stopped.
+struct LatencyRecorder {
+  // Enough for one slot per Verona worker on any machine we run on; beyond
+  // that threads share a slot and an occasional increment may be lost.
+  static constexpr size_t SLOTS = 256;
+
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> counts[LatencyHistogram::BUCKETS];
+    std::atomic<uint64_t> max;
+  };
+
+  bool enabled = false;
+  std::unique_ptr<Slot[]> slots;
+  std::atomic<size_t> next_slot{0};
+  std::atomic<uint64_t> epoch{1};
+
+  static LatencyRecorder& get() {
+    static LatencyRecorder recorder;
+    return recorder;
+  }
+
+  void enable() {
+    enabled = true;
+    slots = std::make_unique<Slot[]>(SLOTS);
+    reset();
+  }
+
+  void reset() {
+    for (size_t s = 0; s < SLOTS; s++) {
+      for (auto& count: slots[s].counts)
+        count.store(0, std::memory_order_relaxed);
+      slots[s].max.store(0, std::memory_order_relaxed);
+    }
+
+    next_slot.store(0, std::memory_order_relaxed);
+    epoch.fetch_add(1, std::memory_order_release);
+  }
+
+  // Only call once the scheduler has stopped.
+  LatencyHistogram merge() {
+    LatencyHistogram histogram;
+
+    for (size_t s = 0; s < SLOTS; s++) {
+      for (size_t i = 0; i < LatencyHistogram::BUCKETS; i++) {
+        uint64_t count = slots[s].counts[i].load(std::memory_order_relaxed);
+        histogram.counts[i] += count;
+        histogram.total += count;
+      }
+      histogram.max = std::max(histogram.max, slots[s].max.load(std::memory_order_relaxed));
+    }
+
+    return histogram;
+  }
+
+  Slot& slot() {
+    thread_local size_t index = 0;
+    thread_local uint64_t claimed = 0;
+
+    uint64_t current = epoch.load(std::memory_order_acquire);
+    if (claimed != current) {
+      index = next_slot.fetch_add(1, std::memory_order_relaxed) % SLOTS;
+      claimed = current;
+    }
+
+    return slots[index];
+  }
+
+  static uint64_t now() {
+    if (!get().enabled)
+      return 0;
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  static void record(uint64_t enqueued) {
+    if (enqueued == 0)
+      return;
+
+    uint64_t latency = now() - enqueued;
+    Slot& slot = get().slot();
+
+    // The slot belongs to this thread, so a plain increment is enough.
+    auto& count = slot.counts[LatencyHistogram::index(latency)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (latency > slot.max.load(std::memory_order_relaxed))
+      slot.max.store(latency, std::memory_order_relaxed);
+  }
+};
+
+// Set by every stamped() behaviour, so that the harness can tell a benchmark
+// whose behaviours were left unwrapped, and would record nothing. With
+// --phases, each thread also records when its last behaviour ended, which
+// separates the runtime shutting down from the benchmark in sched.run().
+struct Stamps {
+  static constexpr size_t SLOTS = 256;
+
+  struct alignas(64) Slot {
+    // high_resolution_clock ticks since its epoch.
+    std::atomic<std::chrono::high_resolution_clock::rep> ended;
+  };
+
+  inline static std::atomic<bool> seen{false};
+  inline static bool timing = false;
+  inline static Slot slots[SLOTS];
+  inline static std::atomic<size_t> next_slot{0};
+  inline static std::atomic<uint64_t> epoch{1};
+
+  static void reset() {
+    seen.store(false, std::memory_order_relaxed);
+    for (Slot& slot: slots)
+      slot.ended.store(0, std::memory_order_relaxed);
+    next_slot.store(0, std::memory_order_relaxed);
+    epoch.fetch_add(1, std::memory_order_release);
+  }
+
+  static void mark() {
+    // Read first, so that the line stays shared once it is set.
+    if (!seen.load(std::memory_order_relaxed))
+      seen.store(true, std::memory_order_relaxed);
+  }
+
+  // Records the end of the behaviour it is created in when it goes out of
+  // scope.
+  struct End {
+    ~End() {
+      if (!timing)
+        return;
+
+      thread_local size_t index = 0;
+      thread_local uint64_t claimed = 0;
+
+      uint64_t current = epoch.load(std::memory_order_acquire);
+      if (claimed != current) {
+        index = next_slot.fetch_add(1, std::memory_order_relaxed) % SLOTS;
+        claimed = current;
+      }
+
+      // Only shared by threads beyond SLOTS, where the latest may be lost.
+      slots[index].ended.store(std::chrono::high_resolution_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+  };
+
+  // When the last stamped behaviour ended, or 0 if none did. Only call once
+  // the scheduler has stopped.
+  static std::chrono::high_resolution_clock::rep last() {
+    std::chrono::high_resolution_clock::rep latest = 0;
+    for (Slot& slot: slots)
+      latest = std::max(latest, slot.ended.load(std::memory_order_relaxed));
+    return latest;
+  }
+};
+
+// Wraps a behaviour so that, when --latency is given, the delay between
+// scheduling it and it starting is recorded, when --trace is given, its
+// execution appears on the timeline, and with --alloc-profile, its closure and
+// what it allocates are attributed to it:
+//
+//   when(a, b) << stamped([](acquired_cown<A> a, acquired_cown<B> b) { ... });
+//
+// With none of them recording, nor --phases, the behaviour runs as it is,
+// without reading the clock.
+template<typename F>
+auto stamped(F&& f) {
+  Stamps::mark();
+
+  bool active = LatencyRecorder::get().enabled || Trace::get().recording || Stamps::timing ||
+    AllocationProfile::enabled.load(std::memory_order_relaxed);
+  if (active)
+    AllocationProfile::closure(typeid(F).name(), sizeof(F));
+
+  return [active, enqueued = active ? LatencyRecorder::now() : 0, f = std::forward<F>(f)](auto&&... cowns) mutable {
+    if (!active)
+      return f(std::forward<decltype(cowns)>(cowns)...);
+
+    LatencyRecorder::record(enqueued);
+    Stamps::End end;
+    Trace::Span span(typeid(F).name(), cowns...);
+    AllocationProfile::Scope scope(typeid(F).name());
+    return f(std::forward<decltype(cowns)>(cowns)...);
+  };
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "allocations.h"
+
+// Process memory as seen by the kernel and by snmalloc.
+namespace memory {
+  // A field of /proc/self/status, such as VmHWM, in bytes.
+  inline uint64_t status(const std::string& field) {
+    std::ifstream in("/proc/self/status");
+    std::string line;
+
+    while (std::getline(in, line))
+      if (line.rfind(field + ":", 0) == 0)
+        return std::stoull(line.substr(field.size() + 1)) * 1024;
+
+    return 0;
+  }
+
+  // Resets the peak RSS (VmHWM) to the current RSS, on Linux 4.0 and later.
+  inline void reset_peak() {
+    std::ofstream("/proc/self/clear_refs") << "5";
+  }
+
+  // Address space snmalloc currently has in use.
+  inline uint64_t allocator_usage() {
+    return snmalloc::Alloc::Config::Backend::get_current_usage();
+  }
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "latency.h"
+#include "random.h"
+
+// Open-loop load, selected with --rate.
+//
+// Every other mode is closed-loop: each client waits for a reply before
+// sending its next request, so a slow server also slows down the arrival of
+// work and queueing delay never builds up. With --rate, a driver thread sends
+// requests at a fixed rate while sched.run() is active, whether or not the
+// earlier ones have been answered. Benchmarks that override
+// AsyncBenchmark::open_loop() receive them through request(intended), and
+// call respond(intended) once each has been served:
+//
+//   when(self) << [intended](acquired_cown<Server> self) {
+//     ...
+//     OpenLoop::respond(intended);
+//   };
+//
+// Response times are measured from when each request was due to be sent,
+// rather than when the driver got round to sending it, so a driver that falls
+// behind still charges its lateness to the requests it delayed.
+struct OpenLoop {
+  // Each thread claims a slot on its first response. Worker threads are
+  // created afresh by every sched.run(), so slots are eventually shared and
+  // the counts have to be atomic.
+  static constexpr size_t SLOTS = 256;
+
+  enum class Arrivals { Poisson, Constant };
+
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> counts[LatencyHistogram::BUCKETS];
+    std::atomic<uint64_t> max;
+  };
+
+  bool enabled = false;
+  // Requests per second, each reported separately.
+  std::vector<uint64_t> rates;
+  Arrivals arrivals = Arrivals::Poisson;
+  std::chrono::milliseconds length{0};
+  // The rate currently being offered, one of rates.
+  uint64_t rate = 0;
+  std::unique_ptr<Slot[]> slots;
+  std::atomic<size_t> next_slot{0};
+
+  static OpenLoop& get() {
+    static OpenLoop open_loop;
+    return open_loop;
+  }
+
+  void enable(const std::string& rate_list, const std::string& arrival_process, std::chrono::milliseconds duration) {
+    std::stringstream list(rate_list);
+    std::string value;
+    while (std::getline(list, value, ',')) {
+      if (value.empty())
+        continue;
+
+      char* end = nullptr;
+      uint64_t r = std::strtoull(value.c_str(), &end, 10);
+      if (*end != '\0' || r == 0) {
+        std::cerr << "ERROR: --rate expects a comma separated list of requests per second, got " << value << std::endl;
+        std::exit(1);
+      }
+      rates.push_back(r);
+    }
+
+    if (rates.empty()) {
+      std::cerr << "ERROR: --rate expects a comma separated list of requests per second" << std::endl;
+      std::exit(1);
+    }
+
+    if (arrival_process == "poisson")
+      arrivals = Arrivals::Poisson;
+    else if (arrival_process == "constant")
+      arrivals = Arrivals::Constant;
+    else {
+      std::cerr << "ERROR: --arrivals expects poisson or constant, got " << arrival_process << std::endl;
+      std::exit(1);
+    }
+
+    if (duration.count() <= 0) {
+      std::cerr << "ERROR: --duration must be positive" << std::endl;
+      std::exit(1);
+    }
+
+    length = duration;
+    rate = rates.front();
+    slots = std::make_unique<Slot[]>(SLOTS);
+    enabled = true;
+    reset();
+  }
+
+  void reset() {
+    for (size_t s = 0; s < SLOTS; s++) {
+      for (auto& count: slots[s].counts)
+        count.store(0, std::memory_order_relaxed);
+      slots[s].max.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // Only call once the scheduler has stopped.
+  LatencyHistogram merge() {
+    LatencyHistogram histogram;
+
+    for (size_t s = 0; s < SLOTS; s++) {
+      for (size_t i = 0; i < LatencyHistogram::BUCKETS; i++) {
+        uint64_t count = slots[s].counts[i].load(std::memory_order_relaxed);
+        histogram.counts[i] += count;
+        histogram.total += count;
+      }
+      histogram.max = std::max(histogram.max, slots[s].max.load(std::memory_order_relaxed));
+    }
+
+    return histogram;
+  }
+
+  static uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  static void respond(uint64_t intended) {
+    OpenLoop& open_loop = get();
+    if (!open_loop.enabled)
+      return;
+
+    uint64_t latency = now() - intended;
+    thread_local size_t index = open_loop.next_slot.fetch_add(1, std::memory_order_relaxed) % SLOTS;
+    Slot& slot = open_loop.slots[index];
+
+    slot.counts[LatencyHistogram::index(latency)].fetch_add(1, std::memory_order_relaxed);
+    uint64_t max = slot.max.load(std::memory_order_relaxed);
+    while (latency > max && !slot.max.compare_exchange_weak(max, latency, std::memory_order_relaxed)) {}
+  }
+
+  // Sends requests to the benchmark at the current rate until length has
+  // passed, then lets it release anything it kept for them. Returns the number
+  // of requests sent.
+  template<typename T>
+  uint64_t drive(T& benchmark, uint64_t seed) {
+    Rand random(seed);
+    double interval = 1e9 / (double)rate;
+    uint64_t start = now();
+    uint64_t end = start + (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(length).count();
+    double offset = 0;
+    uint64_t sent = 0;
+
+    for (;;) {
+      uint64_t intended = start + (uint64_t)offset;
+      if (intended >= end)
+        break;
+
+      uint64_t current = now();
+      if (intended > current)
+        std::this_thread::sleep_for(std::chrono::nanoseconds(intended - current));
+
+      benchmark.request(intended);
+      sent++;
+
+      if (arrivals == Arrivals::Poisson)
+        offset += -std::log(1 - random.real()) * interval;
+      else
+        offset += interval;
+    }
+
+    benchmark.finish();
+    return sent;
+  }
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sstream>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+// Thread and memory placement, selected with --pin and --numa.
+//
+// The runtime sets up its workers in Scheduler::init() and starts their
+// threads in sched.run(), and new threads inherit the CPU affinity and memory
+// policy of the thread that creates them. So rather than pinning each worker
+// individually, the main thread is restricted to the chosen CPUs (and their
+// memory nodes) before Scheduler::init() and for the rest of the repetition,
+// and the workers and everything they allocate follow.
+//
+//   --pin compact       fill one NUMA node before moving to the next
+//   --pin scatter       spread across the NUMA nodes round-robin
+//   --pin list:0,2,4-7  use exactly these CPUs, in this order
+//   --numa local        bind allocations to the nodes of the pinned CPUs
+//   --numa interleave   interleave allocations across those nodes
+//
+// The first c CPUs of the order are used for a run with c cores. The memory
+// policy only affects pages first touched during the repetition, memory the
+// allocator already holds from earlier repetitions stays where it is.
+struct Placement {
+  struct Cpu {
+    size_t id;
+    size_t node;
+  };
+
+  std::string pin;
+  std::string numa;
+  // Every usable CPU, in the order the pinning policy hands them out.
+  std::vector<Cpu> order;
+  cpu_set_t original;
+  bool warned = false;
+
+  // Parses the "0-3,8,10-11" format used by sysfs and --pin list:
+  static std::vector<size_t> parse_list(const std::string& text) {
+    std::vector<size_t> result;
+    std::stringstream list(text);
+    std::string range;
+
+    while (std::getline(list, range, ',')) {
+      if (range.empty() || range == "\n")
+        continue;
+
+      size_t dash = range.find('-');
+      try {
+        size_t first = std::stoul(range.substr(0, dash));
+        size_t last = (dash == std::string::npos) ? first : std::stoul(range.substr(dash + 1));
+        for (size_t cpu = first; cpu <= last; cpu++)
+          result.push_back(cpu);
+      } catch (const std::exception&) {
+        std::cerr << "ERROR: invalid CPU list " << text << std::endl;
+        std::exit(1);
+      }
+    }
+
+    return result;
+  }
+
+  static std::string read_file(const std::string& path) {
+    std::ifstream in(path);
+    std::string contents;
+    std::getline(in, contents);
+    return contents;
+  }
+
+  // The CPUs of each online NUMA node, or a single node with every online
+  // CPU on machines (and containers) without NUMA information.
+  static std::vector<std::vector<size_t>> nodes() {
+    std::vector<std::vector<size_t>> result;
+
+    for (size_t node: parse_list(read_file("/sys/devices/system/node/online")))
+      result.resize(node + 1);
+
+    for (size_t node = 0; node < result.size(); node++)
+      result[node] = parse_list(read_file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+
+    if (result.empty())
+      result.push_back(parse_list(read_file("/sys/devices/system/cpu/online")));
+
+    return result;
+  }
+
+  Placement(const std::string& pin, const std::string& numa): pin(pin), numa(numa) {
+    sched_getaffinity(0, sizeof(original), &original);
+
+    std::vector<std::vector<size_t>> topology = nodes();
+    auto node_of = [&](size_t cpu) {
+      for (size_t node = 0; node < topology.size(); node++)
+        if (std::find(topology[node].begin(), topology[node].end(), cpu) != topology[node].end())
+          return node;
+      return (size_t)0;
+    };
+
+    if (pin.empty() || pin == "compact") {
+      for (size_t node = 0; node < topology.size(); node++)
+        for (size_t cpu: topology[node])
+          order.push_back(Cpu{cpu, node});
+    } else if (pin == "scatter") {
+      for (size_t i = 0; order.size() < cpu_count(topology); i++)
+        for (size_t node = 0; node < topology.size(); node++)
+          if (i < topology[node].size())
+            order.push_back(Cpu{topology[node][i], node});
+    } else if (pin.rfind("list:", 0) == 0) {
+      for (size_t cpu: parse_list(pin.substr(5)))
+        order.push_back(Cpu{cpu, node_of(cpu)});
+    } else {
+      std::cerr << "ERROR: --pin expects compact, scatter or list:<cpus>, got " << pin << std::endl;
+      std::exit(1);
+    }
+
+    // Only offer CPUs this process is allowed to run on.
+    order.erase(std::remove_if(order.begin(), order.end(), [&](const Cpu& cpu) {
+      return (cpu.id >= CPU_SETSIZE) || !CPU_ISSET(cpu.id, &original);
+    }), order.end());
+
+    if (order.empty()) {
+      std::cerr << "ERROR: --pin " << pin << " leaves no usable CPUs" << std::endl;
+      std::exit(1);
+    }
+
+    if (!numa.empty() && numa != "local" && numa != "interleave") {
+      std::cerr << "ERROR: --numa expects local or interleave, got " << numa << std::endl;
+      std::exit(1);
+    }
+  }
+
+  static size_t cpu_count(const std::vector<std::vector<size_t>>& topology) {
+    size_t count = 0;
+    for (const auto& node: topology)
+      count += node.size();
+    return count;
+  }
+
+  // Restrict the calling thread, and so the workers it starts, to the first
+  // `cores` CPUs of the order and their memory nodes.
+  void apply(size_t cores) {
+    if (cores > order.size() && !std::exchange(warned, true))
+      std::cout << "WARNING: only " << order.size() << " CPUs to pin " << cores << " workers to, some will share" << std::endl;
+
+    size_t used = std::min(cores, order.size());
+
+    if (!pin.empty()) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (size_t i = 0; i < used; i++)
+        CPU_SET(order[i].id, &set);
+      if (sched_setaffinity(0, sizeof(set), &set) != 0 && !std::exchange(warned, true))
+        std::cout << "WARNING: could not set CPU affinity" << std::endl;
+    }
+
+    if (!numa.empty()) {
+      unsigned long mask = 0;
+      for (size_t i = 0; i < used; i++)
+        if (order[i].node < (sizeof(mask) * 8))
+          mask |= 1UL << order[i].node;
+
+      int mode = (numa == "interleave") ? MPOL_INTERLEAVE : MPOL_BIND;
+      if (syscall(SYS_set_mempolicy, mode, &mask, sizeof(mask) * 8) != 0 && !std::exchange(warned, true))
+        std::cout << "WARNING: could not set NUMA memory policy" << std::endl;
+    }
+  }
+
+  void restore() {
+    if (!pin.empty())
+      sched_setaffinity(0, sizeof(original), &original);
+
+    if (!numa.empty())
+      syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+  }
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+struct BenchmarkHarness;
+struct BocBenchmark;
+struct Repetition;
+
+// A named benchmark parameter. The value is kept as text so that the default
+// can be overridden from the command line with --param name=value.
+struct Parameter {
+  std::string name;
+  std::string value;
+};
+
+template<typename V>
+struct Param {
+  const char* name;
+  V value;
+};
+
+template<typename V>
+Param<V> param(const char* name, V value) { return Param<V>{name, value}; }
+
+template<typename V>
+std::string format_parameter(const V& value) {
+  std::ostringstream out;
+  out << std::boolalpha << value;
+  return out.str();
+}
+
+template<typename V>
+V parse_parameter(const Parameter& parameter) {
+  std::istringstream in(parameter.value);
+  V value;
+  in >> std::boolalpha >> value;
+
+  if (in.fail() || !(in >> std::ws).eof()) {
+    std::cerr << "ERROR: invalid value '" << parameter.value << "' for parameter " << parameter.name << std::endl;
+    std::exit(1);
+  }
+
+  return value;
+}
+
+struct RegisteredBenchmark {
+  std::string name;
+  std::string paradigm;
+  std::vector<Parameter> parameters;
+  std::function<void(BenchmarkHarness&, const std::vector<Parameter>&)> run;
+  // Constructs the benchmark and returns a function that runs one repetition
+  // of it with the given core count, for --compare to interleave with another.
+  std::function<std::function<Repetition(size_t)>(BenchmarkHarness&, const std::vector<Parameter>&)> prepare;
+
+  // A copy of this benchmark with a different default for one parameter.
+  RegisteredBenchmark with(const std::string& name, const std::string& value) const {
+    RegisteredBenchmark result = *this;
+    for (Parameter& parameter: result.parameters)
+      if (parameter.name == name)
+        parameter.value = value;
+    return result;
+  }
+};
+
+// Every benchmark header registers itself here, in include order, which is
+// the order of the lists in actors/benchmarks.h and boc/benchmarks.h.
+struct Registry {
+  static std::vector<RegisteredBenchmark>& get() {
+    static std::vector<RegisteredBenchmark> benchmarks;
+    return benchmarks;
+  }
+
+  static const RegisteredBenchmark* find(const std::string& paradigm, const std::string& name) {
+    for (const RegisteredBenchmark& benchmark: get())
+      if (benchmark.paradigm == paradigm && benchmark.name == name)
+        return &benchmark;
+    return nullptr;
+  }
+};
+
+template<typename T, typename... Vs, typename Harness, size_t... I>
+void measure_registered(Harness& harness, const std::vector<Parameter>& parameters, std::index_sequence<I...>) {
+  // Re-format the parsed values so that what is reported is what was run.
+  std::vector<Parameter> canonical{Parameter{parameters[I].name, format_parameter(parse_parameter<Vs>(parameters[I]))}...};
+  harness.template measure<T>(canonical, parse_parameter<Vs>(parameters[I])...);
+}
+
+template<typename T, typename... Vs, typename Harness, size_t... I>
+std::function<Repetition(size_t)> prepare_registered(Harness& harness, const std::vector<Parameter>& parameters, std::index_sequence<I...>) {
+  std::shared_ptr<T> benchmark = std::make_shared<T>(parse_parameter<Vs>(parameters[I])...);
+  return [&harness, benchmark](size_t cores) { return harness.run_once(*benchmark, cores); };
+}
+
+// Registers benchmark T, constructed from the given parameters in order:
+//
+//   static const bool registered = register_benchmark<Banking>(param<uint64_t>("accounts", 1000), ...);
+template<typename T, typename... Vs>
+bool register_benchmark(Param<Vs>... defaults) {
+  Registry::get().push_back(RegisteredBenchmark{
+    T::name,
+    std::is_base_of_v<BocBenchmark, T> ? "boc" : "actor",
+    {Parameter{defaults.name, format_parameter(defaults.value)}...},
+    [](auto& harness, const std::vector<Parameter>& parameters) {
+      measure_registered<T, Vs...>(harness, parameters, std::index_sequence_for<Vs...>{});
+    },
+    [](auto& harness, const std::vector<Parameter>& parameters) {
+      return prepare_registered<T, Vs...>(harness, parameters, std::index_sequence_for<Vs...>{});
+    }
+  });
+
+  return true;
+}
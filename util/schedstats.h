@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Scheduler statistics from a runtime built with USE_SCHED_STATS.
+//
+// The runtime prints its statistics to stdout as a CSV row at the end of each
+// sched.run(), tagged with SchedulerStats::get_tag():
+//
+//   SchedulerStats,<tag>,<dump>,<steal>,<lifo>,<pause>,<unpause>,<cowns>,<b0>,...,<b15>
+//
+// where bN is the number of behaviours that acquired N cowns. With --csv or
+// --json, savina-stats captures those rows around sched.run() and reports them
+// as labelled columns instead; other output passes through unchanged.
+struct SchedStats {
+  static constexpr size_t FIRST = 3;
+  static constexpr size_t HISTOGRAM = 16;
+
+  static std::vector<std::string> columns() {
+    std::vector<std::string> names = {"steals", "lifo", "pauses", "unpauses", "cowns"};
+    for (size_t i = 0; i < HISTOGRAM; i++)
+      names.push_back("behaviours_" + std::to_string(i) + "_cowns");
+    return names;
+  }
+
+  std::stringstream captured;
+  std::streambuf* previous = nullptr;
+
+  void begin() {
+    captured.str("");
+    captured.clear();
+    previous = std::cout.rdbuf(captured.rdbuf());
+  }
+
+  // Totals of the rows tagged `tag` printed since begin(), in the order of
+  // columns(), or an empty vector if the runtime printed none.
+  std::vector<uint64_t> end(const std::string& tag) {
+    std::cout.rdbuf(previous);
+
+    std::vector<uint64_t> totals;
+    std::string line;
+
+    while (std::getline(captured, line)) {
+      std::vector<std::string> fields;
+      std::stringstream row(line);
+      std::string field;
+      while (std::getline(row, field, ','))
+        fields.push_back(field);
+
+      bool stats = (fields.size() >= FIRST + 5 + HISTOGRAM) && (fields[1] == tag);
+      if (!stats) {
+        // The header row, or something the benchmark printed.
+        if (fields.size() < 2 || fields[1] != "Tag")
+          std::cout << line << "\n";
+        continue;
+      }
+
+      std::vector<uint64_t> values;
+      try {
+        for (size_t i = 0; i < 5 + HISTOGRAM; i++)
+          values.push_back(std::stoull(fields[FIRST + i]));
+      } catch (const std::exception&) {
+        std::cout << line << "\n";
+        continue;
+      }
+
+      totals.resize(values.size(), 0);
+      for (size_t i = 0; i < values.size(); i++)
+        totals[i] += values[i];
+    }
+
+    std::cout << std::flush;
+    return totals;
+  }
+};
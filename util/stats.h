@@ -1,104 +1,320 @@
 #pragma once
 
-#include <set>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
 
-struct SampleStats {
-  std::vector<double> samples;
-  bool sorted = true;
+// Bounded-memory quantile sketch (KLL, Karnin, Lang and Liberty 2016).
+//
+// Values are buffered in a stack of levels, where a value at level h stands
+// for 2^h of the values added. When a level fills up it is sorted and every
+// other value, starting at a random one of the first two, is promoted to the
+// level above, so the memory used grows only logarithmically with the number
+// of values. With the default k of 400, ranks are within about 1% of the
+// true rank.
+struct QuantileSketch {
+  size_t k;
+  std::vector<std::vector<double>> levels;
+  uint64_t count = 0;
+  // Fixed seed so that the same values always give the same answer.
+  std::mt19937_64 random{42};
 
-  SampleStats() {};
+  QuantileSketch(size_t k = 400): k(k), levels(1) {}
 
-  void add(double sample) {
-    samples.push_back(sample);
-    sorted = false;
-  }
+  void add(double value) {
+    levels[0].push_back(value);
+    count++;
 
-  double sum() {
-    double total = 0;
-    for (const double& sample: samples) {
-      total += sample;
-    }
+    for (size_t h = 0; h < levels.size(); h++) {
+      if (levels[h].size() < capacity(h))
+        break;
 
-    return total;
-  }
+      if (h + 1 == levels.size())
+        levels.emplace_back();
 
-  double mean() { return sum() / samples.size(); }
+      std::vector<double>& level = levels[h];
+      std::sort(level.begin(), level.end());
 
-  double median() {
-    if (std::exchange(sorted, true)) std::sort(samples.begin(), samples.end());
+      // An odd value out stays behind, so no weight is lost.
+      double leftover = level.back();
+      bool odd = (level.size() % 2) == 1;
+      size_t even = level.size() - (odd ? 1 : 0);
+      for (size_t i = random() & 1; i < even; i += 2)
+        levels[h + 1].push_back(level[i]);
+      level.clear();
+      if (odd)
+        level.push_back(leftover);
+    }
+  }
 
-    uint64_t size = samples.size();
+  // Lower levels get geometrically smaller buffers, the top one gets k.
+  size_t capacity(size_t h) const {
+    size_t depth = levels.size() - 1 - h;
+    return std::max<size_t>(2, (size_t)((double)k * std::pow(2.0 / 3.0, (double)depth)));
+  }
 
-    if (size == 0) {
+  // The value at fraction q of the way through everything added.
+  double quantile(double q) const {
+    if (count == 0)
       return 0;
-    } else if (size == 1) {
-      return samples[0];
-    } else {
-      uint64_t middle = size / 2;
 
-      if (size % 2 == 1) {
-        return samples[middle];
-      } else {
-        return (samples[middle - 1] + samples[middle]) / 2.0;
+    std::vector<std::pair<double, uint64_t>> weighted;
+    uint64_t total = 0;
+    for (size_t h = 0; h < levels.size(); h++) {
+      for (double value: levels[h]) {
+        weighted.emplace_back(value, (uint64_t)1 << h);
+        total += (uint64_t)1 << h;
       }
     }
-  }
+    std::sort(weighted.begin(), weighted.end());
 
-  double geometric_mean() {
-    double result = 0;
-
-    for (const double& sample: samples) {
-      result += std::log10(sample);
+    double target = q * (double)total;
+    uint64_t seen = 0;
+    for (const auto& item: weighted) {
+      seen += item.second;
+      if ((double)seen >= target)
+        return item.first;
     }
 
-    return std::pow(result / ((double)samples.size()), 10);
+    return weighted.back().first;
   }
+};
+
+// Summary statistics of a stream of samples, in bounded memory.
+//
+// Moments are accumulated online (Welford), and quantiles come from the
+// samples themselves while there are at most RETAINED of them, and from a
+// QuantileSketch beyond that. samples holds every sample in the order added up
+// to RETAINED, and then a uniform reservoir of them, which the bootstrap and
+// outlier checks resample from. Per-repetition times never get that far, so
+// for those everything is exact.
+struct SampleStats {
+  static constexpr size_t RETAINED = 1 << 14;
+
+  std::vector<double> samples;
+  QuantileSketch sketch;
+  uint64_t count = 0;
+  double total = 0;
+  double mean_ = 0;
+  // Sums of the second and third powers of differences from the mean.
+  double m2 = 0;
+  double m3 = 0;
+  double log_sum = 0;
+  double reciprocal_sum = 0;
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+  std::mt19937_64 random{42};
+
+  SampleStats() {};
+
+  void add(double sample) {
+    count++;
+    double n = (double)count;
+    double delta = sample - mean_;
+    double delta_n = delta / n;
+    double term = delta * delta_n * (n - 1);
+    mean_ += delta_n;
+    m3 += (term * delta_n * (n - 2)) - (3 * delta_n * m2);
+    m2 += term;
 
-  double harmonic_mean() {
-    double denom = 0;
+    total += sample;
+    log_sum += std::log10(sample);
+    reciprocal_sum += 1.0 / sample;
+    min = std::min(min, sample);
+    max = std::max(max, sample);
 
-    for (const double& sample: samples) {
-      denom += (1.0 / sample);
+    if (samples.size() < RETAINED) {
+      samples.push_back(sample);
+    } else {
+      uint64_t slot = random() % count;
+      if (slot < RETAINED)
+        samples[slot] = sample;
     }
 
-    return ((double) samples.size()) / denom;
+    sketch.add(sample);
   }
 
-  double stddev() {
-    double m = mean();
-    double temp = 0;
+  size_t size() const { return count; }
 
-    for (const double& sample: samples) {
-      temp += ((m - sample) * (m - sample));
-    }
+  bool exact() const { return count <= RETAINED; }
+
+  double sum() { return total; }
 
-    return std::sqrt(temp / ((double)samples.size()));
+  double mean() { return count == 0 ? 0 : mean_; }
+
+  double quantile(double q) {
+    if (count == 0)
+      return 0;
+
+    if (!exact())
+      return sketch.quantile(q);
+
+    return quantile_of(samples, q);
   }
 
+  double median() { return quantile(0.5); }
+
+  double geometric_mean() { return std::pow(10, log_sum / ((double)count)); }
+
+  double harmonic_mean() { return ((double)count) / reciprocal_sum; }
+
+  double stddev() { return count == 0 ? 0 : std::sqrt(m2 / ((double)count)); }
+
   double ref_err() { return 100.0 * ((confidence_high() - mean()) / mean()); }
 
   double variation() { return stddev() / mean(); }
 
-  double confidence_low() { return mean() - (1.96 * (stddev() / std::sqrt(samples.size()))); }
+  double confidence_low() { return mean() - (1.96 * (stddev() / std::sqrt(count))); }
 
-  double confidence_high() { return mean() + (1.96 * (stddev() / std::sqrt(samples.size()))); }
+  double confidence_high() { return mean() + (1.96 * (stddev() / std::sqrt(count))); }
 
   double skewness() {
-    double m = mean();
     double sd = stddev();
-    double total = 0;
-    double diff = 0;
 
-    if (samples.size() > 0) {
-      for (const double& sample: samples) {
-        diff = sample - m;
-        total += (diff * diff * diff);
-      }
+    if (count > 0)
+      return m3 / ((((double)count) - 1) * sd * sd * sd);
+    else
+      return 0;
+  }
 
-      return total / ((((double) samples.size()) - 1) * sd * sd * sd);
-    } else {
+  // Median absolute deviation from the median.
+  double mad() {
+    double m = median();
+    std::vector<double> deviations;
+    for (double sample: samples)
+      deviations.push_back(std::abs(sample - m));
+
+    return quantile_of(std::move(deviations), 0.5);
+  }
+
+  // Samples whose modified z-score, 0.6745 * (x - median) / MAD, is beyond
+  // threshold (Iglewicz and Hoaglin), counted among the retained samples.
+  size_t outliers(double threshold = 3.5) {
+    double m = median();
+    double deviation = mad();
+    if (deviation == 0)
       return 0;
+
+    size_t flagged = 0;
+    for (double sample: samples)
+      if (std::abs(0.6745 * (sample - m) / deviation) > threshold)
+        flagged++;
+
+    return flagged;
+  }
+
+  // Percentile bootstrap confidence interval for the median.
+  std::pair<double, double> bootstrap_median(double confidence = 0.95, size_t resamples = 2000) {
+    if (samples.empty())
+      return {0, 0};
+
+    // Fixed seed so that the same samples always give the same interval.
+    std::mt19937_64 generator(42);
+    std::uniform_int_distribution<size_t> pick(0, samples.size() - 1);
+    std::vector<double> resample(samples.size());
+    std::vector<double> medians;
+    for (size_t r = 0; r < resamples; r++) {
+      for (double& value: resample)
+        value = samples[pick(generator)];
+      medians.push_back(quantile_of(resample, 0.5));
     }
+    std::sort(medians.begin(), medians.end());
+
+    double tail = (1 - confidence) / 2;
+    return {medians[(size_t)(tail * (double)(resamples - 1))], medians[(size_t)((1 - tail) * (double)(resamples - 1))]};
+  }
+
+  // Interpolates between the two closest values, so that the median of an
+  // even number of values is the mean of the middle two.
+  static double quantile_of(std::vector<double> values, double q) {
+    if (values.empty())
+      return 0;
+
+    double position = q * (double)(values.size() - 1);
+    size_t below = (size_t)position;
+    size_t above = std::min(below + 1, values.size() - 1);
+    std::nth_element(values.begin(), values.begin() + below, values.end());
+    double low = values[below];
+    if (above == below)
+      return low;
+
+    double high = *std::min_element(values.begin() + below + 1, values.end());
+    return low + ((position - (double)below) * (high - low));
+  }
+};
+
+// Two-sided Mann-Whitney U test of whether samples from a and b come from the
+// same distribution, using the normal approximation with a tie correction.
+// Returns the p-value.
+inline double mann_whitney(const std::vector<double>& a, const std::vector<double>& b) {
+  double n1 = (double)a.size();
+  double n2 = (double)b.size();
+  double n = n1 + n2;
+
+  if (a.empty() || b.empty())
+    return 1;
+
+  std::vector<std::pair<double, bool>> all;
+  for (double x: a)
+    all.emplace_back(x, true);
+  for (double x: b)
+    all.emplace_back(x, false);
+  std::sort(all.begin(), all.end());
+
+  double rank_sum = 0;
+  double ties = 0;
+  for (size_t i = 0; i < all.size();) {
+    size_t j = i;
+    while (j < all.size() && all[j].first == all[i].first)
+      j++;
+
+    // Tied values share the average of their ranks.
+    double rank = (double)(i + j + 1) / 2;
+    for (size_t k = i; k < j; k++)
+      if (all[k].second)
+        rank_sum += rank;
+
+    double t = (double)(j - i);
+    ties += (t * t * t) - t;
+    i = j;
   }
-};
\ No newline at end of file
+
+  double u = rank_sum - ((n1 * (n1 + 1)) / 2);
+  double mu = (n1 * n2) / 2;
+  double sigma = std::sqrt(((n1 * n2) / 12) * ((n + 1) - (ties / (n * (n - 1)))));
+
+  if (sigma == 0)
+    return 1;
+
+  // Continuity correction.
+  double z = std::max(0.0, std::abs(u - mu) - 0.5) / sigma;
+  return std::erfc(z / std::sqrt(2.0));
+}
+
+// Percentile bootstrap confidence interval for median(a) / median(b).
+inline std::pair<double, double> bootstrap_ratio(const std::vector<double>& a, const std::vector<double>& b, double confidence = 0.95, size_t resamples = 2000) {
+  // Fixed seed so that the same samples always give the same interval.
+  std::mt19937_64 random(42);
+
+  auto median_of = [&](const std::vector<double>& samples) {
+    std::uniform_int_distribution<size_t> pick(0, samples.size() - 1);
+    std::vector<double> resample(samples.size());
+    for (double& value: resample)
+      value = samples[pick(random)];
+    return SampleStats::quantile_of(std::move(resample), 0.5);
+  };
+
+  std::vector<double> ratios;
+  for (size_t r = 0; r < resamples; r++)
+    ratios.push_back(median_of(a) / median_of(b));
+  std::sort(ratios.begin(), ratios.end());
+
+  double tail = (1 - confidence) / 2;
+  size_t low = (size_t)(tail * (double)(resamples - 1));
+  size_t high = (size_t)((1 - tail) * (double)(resamples - 1));
+  return {ratios[low], ratios[high]};
+}
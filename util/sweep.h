@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Parallel seed sweeps for savina-sys, selected with --jobs N.
+//
+// Without it, --seed_count runs the seeds one after another in one process.
+// With it, the seeds are handed out in order to up to N processes at a time,
+// each forked to run a single seed, so a seed that crashes doesn't take the
+// rest with it and every seed runs from the same state it would with
+// --seed S --seed_count 1. A seed fails if its process is killed by a signal
+// (an assertion or the leak check), exits with a failure (--validate), or runs
+// for longer than --seed-timeout. The lowest failing seed is then run again
+// with logging on, and its output kept, so the first divergence can be read
+// without reproducing it by hand.
+struct SeedSweep {
+  struct Failure {
+    uint64_t seed;
+    std::string reason;
+  };
+
+  struct Running {
+    uint64_t seed;
+    std::chrono::steady_clock::time_point started;
+  };
+
+  // Exit status of a seed whose result failed --validate.
+  static constexpr int INVALID = 3;
+
+  size_t jobs;
+  std::chrono::seconds timeout;
+  // Where the log of the first failing seed of each benchmark is written.
+  std::string logs;
+
+  SeedSweep(size_t jobs, std::chrono::seconds timeout, std::string logs): jobs(jobs), timeout(timeout), logs(std::move(logs)) {}
+
+  // Runs seeds first to first + count - 1 of `name`. `attempt` is called in a
+  // child with the seed, and returns whether the seed passed. Returns the
+  // failing seeds in order.
+  std::vector<Failure> run(const std::string& name, uint64_t first, uint64_t count,
+                           const std::function<bool(uint64_t)>& attempt, const std::function<void()>& enable_logging) {
+    std::map<pid_t, Running> running;
+    std::vector<Failure> failures;
+    uint64_t next = first;
+    uint64_t finished = 0;
+    uint64_t reported = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::cout << std::flush;
+    std::cerr << std::flush;
+    fflush(nullptr);
+
+    while (next < first + count || !running.empty()) {
+      while (running.size() < jobs && next < first + count) {
+        uint64_t seed = next++;
+        pid_t child = fork();
+        if (child < 0) {
+          std::cerr << "ERROR: --jobs could not fork: " << std::strerror(errno) << std::endl;
+          std::exit(1);
+        }
+
+        if (child == 0) {
+          quiet();
+          _exit(attempt(seed) ? 0 : INVALID);
+        }
+
+        running[child] = Running{seed, std::chrono::steady_clock::now()};
+      }
+
+      int status = 0;
+      pid_t done = waitpid(-1, &status, WNOHANG);
+      if (done < 0 && errno != EINTR) {
+        std::cerr << "ERROR: --jobs lost track of its children: " << std::strerror(errno) << std::endl;
+        std::exit(1);
+      }
+
+      if (done <= 0) {
+        // Nothing has finished, so look for seeds that never will.
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        for (const auto& child: running)
+          if (now - child.second.started > timeout)
+            kill(child.first, SIGKILL);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        continue;
+      }
+
+      auto it = running.find(done);
+      if (it == running.end())
+        continue;
+
+      Running seed = it->second;
+      running.erase(it);
+      finished++;
+
+      std::string reason = describe(status, std::chrono::steady_clock::now() - seed.started > timeout);
+      if (!reason.empty())
+        failures.push_back(Failure{seed.seed, reason});
+
+      // Roughly every tenth of the way, as a sweep can take a while.
+      if (finished * 10 / count > reported) {
+        reported = finished * 10 / count;
+        std::cout << name << ": " << finished << " of " << count << " seeds, " << failures.size() << " failed" << std::endl;
+      }
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::sort(failures.begin(), failures.end(), [](const Failure& a, const Failure& b) { return a.seed < b.seed; });
+
+    std::cout << name << ": swept " << count << " seeds from " << first << " in " << elapsed << " s with " << jobs
+              << " jobs, " << failures.size() << " failed" << std::endl;
+
+    const size_t shown = 20;
+    for (size_t i = 0; i < std::min(failures.size(), shown); i++)
+      std::cout << "  seed " << failures[i].seed << ": " << failures[i].reason << std::endl;
+    if (failures.size() > shown)
+      std::cout << "  and " << (failures.size() - shown) << " more" << std::endl;
+
+    if (!failures.empty())
+      replay(name, failures.front().seed, attempt, enable_logging);
+
+    return failures;
+  }
+
+  // Runs seed again with logging on, writing everything it prints to a file.
+  void replay(const std::string& name, uint64_t seed, const std::function<bool(uint64_t)>& attempt, const std::function<void()>& enable_logging) {
+    std::string file = name;
+    std::replace(file.begin(), file.end(), ' ', '-');
+    file = logs + "/" + file + "-seed-" + std::to_string(seed) + ".log";
+
+    // Anything still buffered would otherwise be written by both processes.
+    std::cout << std::flush;
+    std::cerr << std::flush;
+    fflush(nullptr);
+
+    pid_t child = fork();
+    if (child == 0) {
+      int fd = open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0)
+        _exit(2);
+      dup2(fd, STDOUT_FILENO);
+      dup2(fd, STDERR_FILENO);
+      close(fd);
+
+      enable_logging();
+      bool passed = attempt(seed);
+
+      // _exit doesn't flush, and the log is what the replay is for.
+      std::cout << std::flush;
+      std::cerr << std::flush;
+      fflush(nullptr);
+      _exit(passed ? 0 : INVALID);
+    }
+
+    int status = 0;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    while (child > 0 && waitpid(child, &status, WNOHANG) == 0) {
+      if (std::chrono::steady_clock::now() - started > timeout)
+        kill(child, SIGKILL);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::cout << "  log of seed " << seed << ": " << file << std::endl
+              << "  reproduce with --seed " << seed << " --seed_count 1" << std::endl;
+  }
+
+  // Empty for a seed that passed.
+  static std::string describe(int status, bool timed_out) {
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+      return "";
+
+    if (WIFEXITED(status) && WEXITSTATUS(status) == INVALID)
+      return "failed validation";
+
+    if (WIFEXITED(status))
+      return "exited with status " + std::to_string(WEXITSTATUS(status));
+
+    if (timed_out)
+      return "timed out";
+
+    if (WIFSIGNALED(status))
+      return "killed by signal " + std::to_string(WTERMSIG(status)) + " (" + strsignal(WTERMSIG(status)) + ")";
+
+    return "stopped";
+  }
+
+  // Each seed's own output would drown out the summary.
+  static void quiet() {
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd >= 0) {
+      dup2(fd, STDOUT_FILENO);
+      dup2(fd, STDERR_FILENO);
+      close(fd);
+    }
+  }
+};
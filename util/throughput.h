@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Fixed-duration throughput mode, selected with --duration.
+//
+// Benchmarks that can run indefinitely override AsyncBenchmark::continuous(),
+// ask more() wherever they would otherwise stop after a fixed amount of work,
+// and call completed() for each operation they finish:
+//
+//   if (Throughput::more(self->left > 0)) { ... }
+//
+// Outside of --duration more() just returns its argument, so the normal fixed
+// workload is unchanged.
+struct Throughput {
+  static constexpr size_t SLOTS = 256;
+
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> count;
+  };
+
+  inline static bool enabled = false;
+  inline static std::atomic<bool> expired{false};
+  inline static Slot slots[SLOTS];
+  inline static std::atomic<size_t> next_slot{0};
+
+  static bool more(bool remaining) {
+    if (!enabled)
+      return remaining;
+
+    return !expired.load(std::memory_order_relaxed);
+  }
+
+  static void completed(uint64_t operations = 1) {
+    if (!enabled)
+      return;
+
+    thread_local size_t index = next_slot.fetch_add(1, std::memory_order_relaxed) % SLOTS;
+    slots[index].count.fetch_add(operations, std::memory_order_relaxed);
+  }
+
+  static uint64_t total() {
+    uint64_t count = 0;
+    for (Slot& slot: slots)
+      count += slot.count.load(std::memory_order_relaxed);
+    return count;
+  }
+
+  // Parses "10s", "250ms" or a plain number of seconds.
+  static std::chrono::milliseconds parse(const std::string& option, const std::string& text) {
+    size_t end = 0;
+    double value = 0;
+    try {
+      value = std::stod(text, &end);
+    } catch (const std::exception&) {
+      end = std::string::npos;
+    }
+
+    std::string unit = (end == std::string::npos) ? "?" : text.substr(end);
+    if (unit == "ms")
+      return std::chrono::milliseconds((int64_t)value);
+    if (unit == "s" || unit.empty())
+      return std::chrono::milliseconds((int64_t)(value * 1000));
+
+    std::cerr << "ERROR: " << option << " expects a duration such as 10s or 250ms, got " << text << std::endl;
+    std::exit(1);
+  }
+
+  // Lets the benchmark run for `length`, recording the rate of completed
+  // operations (per second) over each interval, then tells it to stop. Runs
+  // on its own thread while the main thread is inside sched.run().
+  static std::vector<double> sample(std::chrono::milliseconds length, std::chrono::milliseconds interval) {
+    using namespace std::chrono;
+
+    std::vector<double> rates;
+    steady_clock::time_point start = steady_clock::now();
+    steady_clock::time_point deadline = start + length;
+    steady_clock::time_point previous = start;
+    uint64_t previous_total = 0;
+
+    while (previous < deadline) {
+      std::this_thread::sleep_until(std::min(previous + interval, deadline));
+
+      steady_clock::time_point now = steady_clock::now();
+      uint64_t current = total();
+      rates.push_back((double)(current - previous_total) / duration_cast<duration<double>>(now - previous).count());
+      previous = now;
+      previous_total = current;
+    }
+
+    expired.store(true, std::memory_order_relaxed);
+    return rates;
+  }
+
+  static void reset() {
+    for (Slot& slot: slots)
+      slot.count.store(0, std::memory_order_relaxed);
+    expired.store(false, std::memory_order_relaxed);
+  }
+};
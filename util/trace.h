@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "allocations.h"
+#include "json.h"
+
+// Timeline of behaviour execution, selected with --trace out.json.
+//
+// Every behaviour wrapped with stamped() records when it started and ended on
+// its worker thread and which cowns it acquired. Each thread appends to a ring
+// buffer of its own, so recording takes no locks, and once the buffer is full
+// the oldest events are overwritten. Only the first measured repetition of each
+// benchmark is traced, and it is written out in the Chrome trace-event format,
+// which opens in Perfetto (ui.perfetto.dev) or chrome://tracing, with one
+// process per benchmark, one track per worker, and each event named after the
+// behaviour's lambda.
+struct Trace {
+  static constexpr size_t MAX_COWNS = 4;
+
+  struct Event {
+    // The mangled lambda type of the behaviour.
+    const char* behaviour;
+    uint64_t start;
+    uint64_t end;
+    uint32_t cowns;
+    // The address of each acquired cown's contents, which identifies it.
+    uintptr_t ids[MAX_COWNS];
+  };
+
+  struct Buffer {
+    size_t thread;
+    std::vector<Event> events;
+    uint64_t recorded = 0;
+
+    Buffer(size_t thread, size_t capacity): thread(thread), events(capacity) {}
+  };
+
+  bool enabled = false;
+  // Only while the traced repetition runs.
+  bool recording = false;
+  size_t capacity = 0;
+  std::ofstream out;
+  bool first = true;
+  size_t process = 0;
+  uint64_t origin = 0;
+  std::mutex lock;
+  std::vector<std::unique_ptr<Buffer>> buffers;
+  std::atomic<uint64_t> epoch{1};
+
+  static Trace& get() {
+    static Trace trace;
+    return trace;
+  }
+
+  void open(const std::string& filename, size_t events) {
+    out.open(filename);
+    if (!out) {
+      std::cerr << "ERROR: could not open " << filename << " for writing" << std::endl;
+      std::exit(1);
+    }
+
+    enabled = true;
+    capacity = events;
+    out << std::fixed << std::setprecision(3) << "{\"traceEvents\": [";
+  }
+
+  ~Trace() {
+    if (enabled)
+      out << "\n], \"displayTimeUnit\": \"ms\"}" << std::endl;
+  }
+
+  static uint64_t now() {
+    if (!get().recording)
+      return 0;
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  // Starts tracing a repetition, discarding the buffers of the previous one.
+  void begin() {
+    buffers.clear();
+    epoch.fetch_add(1, std::memory_order_release);
+    recording = true;
+    origin = now();
+  }
+
+  // The calling thread's buffer, claimed on its first event of the repetition.
+  Buffer& buffer() {
+    thread_local Buffer* current = nullptr;
+    thread_local uint64_t claimed = 0;
+
+    uint64_t latest = epoch.load(std::memory_order_acquire);
+    if (claimed != latest) {
+      std::lock_guard<std::mutex> guard(lock);
+      buffers.push_back(std::make_unique<Buffer>(buffers.size(), capacity));
+      current = buffers.back().get();
+      claimed = latest;
+    }
+
+    return *current;
+  }
+
+  void record(const Event& event) {
+    Buffer& b = buffer();
+    b.events[b.recorded++ % b.events.size()] = event;
+  }
+
+  // Stops tracing and writes out the repetition. Only call once the scheduler
+  // has stopped.
+  void end(const std::string& benchmark, const std::string& paradigm, size_t cores) {
+    recording = false;
+
+    size_t pid = process++;
+    uint64_t total = 0;
+    uint64_t dropped = 0;
+    // Demangled once for each behaviour rather than for each event.
+    std::map<const char*, std::string> names;
+
+    event("{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " + std::to_string(pid) +
+          ", \"args\": {\"name\": " + JSONValue::quote(benchmark + " (" + paradigm + ", " + std::to_string(cores) + " cores)") + "}}");
+
+    for (const std::unique_ptr<Buffer>& b: buffers) {
+      event("{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " + std::to_string(pid) +
+            ", \"tid\": " + std::to_string(b->thread) + ", \"args\": {\"name\": \"worker " + std::to_string(b->thread) + "\"}}");
+
+      size_t size = b->events.size();
+      size_t kept = (size_t)std::min<uint64_t>(b->recorded, size);
+      total += b->recorded;
+      dropped += b->recorded - kept;
+
+      // Oldest first, from where the ring buffer will next write.
+      for (size_t i = 0; i < kept; i++) {
+        const Event& e = b->events[(b->recorded - kept + i) % size];
+        auto name = names.find(e.behaviour);
+        if (name == names.end())
+          name = names.emplace(e.behaviour, JSONValue::quote(AllocationProfile::demangle(e.behaviour))).first;
+
+        out << (std::exchange(first, false) ? "\n" : ",\n")
+            << "{\"name\": " << name->second << ", \"cat\": " << JSONValue::quote(paradigm) << ", \"ph\": \"X\""
+            << ", \"pid\": " << pid << ", \"tid\": " << b->thread
+            << ", \"ts\": " << (double)(e.start - origin) / 1000
+            << ", \"dur\": " << (double)(e.end - e.start) / 1000
+            << ", \"args\": {\"cowns\": [";
+        for (uint32_t c = 0; c < std::min<uint32_t>(e.cowns, MAX_COWNS); c++)
+          out << (c == 0 ? "" : ", ") << "\"0x" << std::hex << e.ids[c] << std::dec << "\"";
+        out << "]}}";
+      }
+    }
+
+    out << std::flush;
+    buffers.clear();
+
+    if (total == 0)
+      std::cout << "WARNING: --trace recorded no behaviours for " << benchmark << ", only those wrapped with stamped() are traced" << std::endl;
+    else if (dropped > 0)
+      std::cout << "WARNING: --trace kept the last " << (total - dropped) << " of " << total << " behaviours of " << benchmark
+                << ", raise --trace-events to keep more" << std::endl;
+  }
+
+  void event(const std::string& json) {
+    out << (std::exchange(first, false) ? "\n" : ",\n") << json;
+  }
+
+  // Records the behaviour it is created in when it goes out of scope.
+  struct Span {
+    Event event;
+
+    template<typename... Cowns>
+    Span(const char* behaviour, Cowns&... cowns): event{behaviour, now(), 0, (uint32_t)sizeof...(Cowns), {}} {
+      if (event.start == 0)
+        return;
+
+      size_t i = 0;
+      ((i < MAX_COWNS ? (void)(event.ids[i++] = reinterpret_cast<uintptr_t>(cowns.operator->())) : (void)0), ...);
+    }
+
+    ~Span() {
+      if (event.start == 0)
+        return;
+
+      event.end = now();
+      if (event.end != 0)
+        get().record(event);
+    }
+  };
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "completion.h"
+
+// Result checking, selected with --validate.
+//
+// A benchmark that can be checked overrides AsyncBenchmark::validates() and
+// validate(). Its run() takes a completion from a Result, which the behaviour
+// that finishes the computation calls with the answer:
+//
+//   when(total) << [done = result.completion()](acquired_cown<uint64_t> total) {
+//     done(*total);
+//   };
+//
+// Once sched.run() has returned and the clock has stopped, the harness calls
+// validate(), which compares the answer with a sequential reference.
+namespace validation {
+  inline bool enabled = false;
+
+  // Whether completions are worth calling at all, either for the answer or
+  // for when it was ready.
+  inline bool wanted() { return enabled || CompletionLatch::enabled.load(std::memory_order_relaxed); }
+
+  template<typename T>
+  struct Result {
+    std::optional<T> value;
+
+    // Does nothing without --validate, so that the answer isn't copied out in
+    // timed runs.
+    struct Completion {
+      Result* result = nullptr;
+
+      // Also marks the benchmark's logical end for --completion.
+      void operator()(T answer) const {
+        if (result != nullptr)
+          result->value = std::move(answer);
+        CompletionLatch::signal();
+      }
+    };
+
+    // Called from run(), forgetting the answer of any previous run.
+    Completion completion() {
+      value.reset();
+      return Completion{enabled ? this : nullptr};
+    }
+  };
+
+  // A description of the problem, or an empty string if actual is expected.
+  template<typename T>
+  std::string expect(const std::string& what, const std::optional<T>& actual, const T& expected) {
+    if (!actual)
+      return what + " was never produced";
+
+    if (*actual == expected)
+      return "";
+
+    std::ostringstream out;
+    out << what << " is " << *actual << ", expected " << expected;
+    return out.str();
+  }
+
+  // Reports the first element that differs.
+  template<typename T>
+  std::string expect_elements(const std::string& what, const std::optional<std::vector<T>>& actual, const std::vector<T>& expected) {
+    if (!actual)
+      return what + " was never produced";
+
+    std::ostringstream out;
+    if (actual->size() != expected.size()) {
+      out << what << " has " << actual->size() << " elements, expected " << expected.size();
+      return out.str();
+    }
+
+    for (size_t i = 0; i < expected.size(); i++) {
+      if ((*actual)[i] != expected[i]) {
+        out << what << "[" << i << "] is " << (*actual)[i] << ", expected " << expected[i];
+        return out.str();
+      }
+    }
+
+    return "";
+  }
+
+  // Composite Simpson's rule over [left, right] with an even number of
+  // intervals, for checking an integral independently of how the benchmark
+  // computes it.
+  template<typename F>
+  double simpson(F f, double left, double right, uint64_t intervals) {
+    double h = (right - left) / (double)intervals;
+    double sum = f(left) + f(right);
+    for (uint64_t i = 1; i < intervals; i++)
+      sum += f(left + (double)i * h) * ((i % 2 == 1) ? 4 : 2);
+    return sum * h / 3;
+  }
+
+  // For floating point results that are summed in a nondeterministic order.
+  inline std::string expect_near(const std::string& what, const std::optional<double>& actual, double expected, double tolerance = 1e-9) {
+    if (!actual)
+      return what + " was never produced";
+
+    if (std::abs(*actual - expected) <= tolerance * std::max(1.0, std::abs(expected)))
+      return "";
+
+    std::ostringstream out;
+    out.precision(17);
+    out << what << " is " << *actual << ", expected " << expected;
+    return out.str();
+  }
+};